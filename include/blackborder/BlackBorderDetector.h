@@ -2,6 +2,8 @@
 
 // Utils includes
 #include <utils/Image.h>
+#include <utils/ImageView.h>
+#include <utils/ColorRgb.h>
 
 namespace hyperion
 {
@@ -39,8 +41,11 @@ namespace hyperion
 
 	///
 	/// The BlackBorderDetector performs detection of black-borders on a single image.
-	/// The detector will search for the upper left corner of the picture in the frame.
-	/// Based on detected black pixels it will give an estimate of the black-border.
+	/// The detector searches the upper left corner of the picture in the frame. The top border is
+	/// probed along a few columns in the middle of the image and the left border along a few rows
+	/// in the middle of the picture. The probed borders are then confirmed by checking that the
+	/// complete row (or column) next to the picture is black, which prevents dark parts of the
+	/// picture from being taken for a border.
 	///
 	class BlackBorderDetector
 	{
@@ -54,65 +59,181 @@ namespace hyperion
 		///
 		/// Performs the actual black-border detection on the given image
 		///
-		/// @param[in] image  The image on which detection is performed
+		/// @param[in] image  The image (or view on a frame) on which detection is performed
 		///
 		/// @return The detected (or not detected) black border info
 		///
-		template <typename Pixel_T>
-		BlackBorder process(const Image<Pixel_T> & image)
+		template <typename Image_T>
+		BlackBorder process(const Image_T & image)
 		{
-			// only test the topleft third of the image
-			int width = image.width() /3;
-			int height = image.height() / 3;
-			int maxSize = std::max(width, height);
+			const int width = image.width();
+			const int height = image.height();
+
+			// Construct result (unknown until both borders are found)
+			BlackBorder detectedBorder = {true, -1, -1};
 
-			int firstNonBlackXPixelIndex = -1;
-			int firstNonBlackYPixelIndex = -1;
+			// probe the top third of the image along a few columns (clear of any vertical border)
+			int horizontalSize = -1;
+			for (int i = 1; i <= PROBE_COUNT; ++i)
+			{
+				const int y = firstNonBlackRow(image, width * i / (PROBE_COUNT+1), height / 3);
+				if (y >= 0 && (horizontalSize == -1 || y < horizontalSize))
+				{
+					horizontalSize = y;
+				}
+			}
+			if (horizontalSize == -1)
+			{
+				return detectedBorder;
+			}
 
-			// find some pixel of the image
-			for (int i = 0; i < maxSize; ++i)
+			// the border ends at the first row which is not black over the complete width
+			while (horizontalSize > 0 && !isBlackRow(image, horizontalSize - 1))
 			{
-				int x = std::min(i, width);
-				int y = std::min(i, height);
+				--horizontalSize;
+			}
 
-				const Pixel_T & color = image(x, y);
-				if (!isBlack(color))
+			// probe the left third of the image along a few rows of the picture
+			int verticalSize = -1;
+			for (int i = 1; i <= PROBE_COUNT; ++i)
+			{
+				const int y = horizontalSize + (height - 2*horizontalSize) * i / (PROBE_COUNT+1);
+				const int x = firstNonBlackColumn(image, y, width / 3);
+				if (x >= 0 && (verticalSize == -1 || x < verticalSize))
 				{
-					firstNonBlackXPixelIndex = x;
-					firstNonBlackYPixelIndex = y;
-					break;
+					verticalSize = x;
 				}
 			}
+			if (verticalSize == -1)
+			{
+				return detectedBorder;
+			}
+
+			// the border ends at the first column which is not black over the height of the picture
+			while (verticalSize > 0 && !isBlackColumn(image, verticalSize - 1, horizontalSize, height - horizontalSize))
+			{
+				--verticalSize;
+			}
+
+			detectedBorder.unknown = false;
+			detectedBorder.horizontalSize = horizontalSize;
+			detectedBorder.verticalSize = verticalSize;
+			return detectedBorder;
+		}
+
+	private:
+		/// The number of rows/columns probed per border
+		static const int PROBE_COUNT = 3;
 
-			// expand image to the left
-			for(; firstNonBlackXPixelIndex > 0; --firstNonBlackXPixelIndex)
+		///
+		/// Searches the first pixel which is not black in the given column
+		///
+		/// @param[in] image  The image
+		/// @param[in] x  The column to search
+		/// @param[in] maxY  The end of the search
+		///
+		/// @return The row of the first pixel which is not black (-1 if all pixels are black)
+		///
+		template <typename Image_T>
+		int firstNonBlackRow(const Image_T & image, int x, int maxY)
+		{
+			for (int y = 0; y < maxY; ++y)
 			{
-				const Pixel_T & color = image(firstNonBlackXPixelIndex-1, firstNonBlackYPixelIndex);
-				if (isBlack(color))
+				if (!isBlack(image(x, y)))
 				{
-					break;
+					return y;
 				}
 			}
+			return -1;
+		}
 
-			// expand image to the top
-			for(; firstNonBlackYPixelIndex > 0; --firstNonBlackYPixelIndex)
+		///
+		/// Searches the first pixel which is not black in the given row
+		///
+		/// @param[in] image  The image
+		/// @param[in] y  The row to search
+		/// @param[in] maxX  The end of the search
+		///
+		/// @return The column of the first pixel which is not black (-1 if all pixels are black)
+		///
+		template <typename Image_T>
+		int firstNonBlackColumn(const Image_T & image, int y, int maxX)
+		{
+			for (int x = 0; x < maxX; ++x)
 			{
-				const Pixel_T & color = image(firstNonBlackXPixelIndex, firstNonBlackYPixelIndex-1);
-				if (isBlack(color))
+				if (!isBlack(image(x, y)))
 				{
-					break;
+					return x;
 				}
 			}
+			return -1;
+		}
 
-			// Construct result
-			BlackBorder detectedBorder;
-			detectedBorder.unknown = firstNonBlackXPixelIndex == -1 || firstNonBlackYPixelIndex == -1;
-			detectedBorder.horizontalSize = firstNonBlackYPixelIndex;
-			detectedBorder.verticalSize = firstNonBlackXPixelIndex;
-			return detectedBorder;
+		///
+		/// Checks if all pixels of the given row are black
+		///
+		/// @param[in] image  The image
+		/// @param[in] y  The row to check
+		///
+		/// @return True if the complete row is black
+		///
+		template <typename Image_T>
+		bool isBlackRow(const Image_T & image, int y)
+		{
+			bool black = true;
+			for (unsigned x = 0; x < image.width(); ++x)
+			{
+				black &= isBlack(image(x, y));
+			}
+			return black;
 		}
 
-	private:
+		///
+		/// Checks if all pixels of the given row are black. Rgb images are checked on their raw
+		/// bytes, which is vectorised by the compiler.
+		///
+		/// @param[in] image  The image
+		/// @param[in] y  The row to check
+		///
+		/// @return True if the complete row is black
+		///
+		bool isBlackRow(const Image<ColorRgb> & image, int y)
+		{
+			return isBlackRow(ImageView<ColorRgb>(image), y);
+		}
+
+		///
+		/// Checks if all pixels of the given row of a view on an rgb image are black
+		///
+		/// @param[in] image  The view on the image
+		/// @param[in] y  The row to check
+		///
+		/// @return True if the complete row is black
+		///
+		bool isBlackRow(const ImageView<ColorRgb> & image, int y);
+
+		///
+		/// Checks if all pixels of the given part of a column are black
+		///
+		/// @param[in] image  The image
+		/// @param[in] x  The column to check
+		/// @param[in] yBegin  The first row to check
+		/// @param[in] yEnd  The end of the rows to check
+		///
+		/// @return True if the part of the column is black
+		///
+		template <typename Image_T>
+		bool isBlackColumn(const Image_T & image, int x, int yBegin, int yEnd)
+		{
+			for (int y = yBegin; y < yEnd; ++y)
+			{
+				if (!isBlack(image(x, y)))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
 
 		///
 		/// Checks if a given color is considered black and therefor could be part of the border.
@@ -22,12 +22,15 @@ namespace hyperion
 		/// @param blurRemoveCnt The size to add to a horizontal or vertical border (because the
 		///                      outer pixels is blurred (black and color combined due to image scaling))
 		/// @param[in] blackborderThreshold The threshold which the blackborder detector should use
+		/// @param[in] detectionInterval The number of frames between two detections (the frame
+		///                              counts above are still in frames)
 		///
 		BlackBorderProcessor(
 				const unsigned unknownFrameCnt,
 				const unsigned borderFrameCnt,
 				const unsigned blurRemoveCnt,
-				uint8_t blackborderThreshold);
+				uint8_t blackborderThreshold,
+				const unsigned detectionInterval = 1);
 
 		///
 		/// Return the current (detected) border
@@ -36,17 +39,34 @@ namespace hyperion
 		BlackBorder getCurrentBorder() const;
 
 		///
-		/// Processes the image. This performs detecion of black-border on the given image and
-		/// updates the current border accordingly. If the current border is updated the method call
-		/// will return true else false
+		/// Shifts the current border for images from which the source already removed part of the
+		/// border (or restored part of a removed border). The consistency of the detected borders
+		/// is kept, so the border does not have to be detected again.
 		///
-		/// @param image The image to process
+		/// @param horizontalShift The number of rows removed at the top and at the bottom
+		/// @param verticalShift The number of columns removed at the left and at the right
+		///
+		void shiftBorder(int horizontalShift, int verticalShift);
+
+		///
+		/// Processes the image. This performs detecion of black-border on the given image (if it
+		/// is the frame of the detection interval) and updates the current border accordingly. If
+		/// the current border is updated the method call will return true else false
+		///
+		/// @param image The image (or view on a frame) to process
 		///
 		/// @return True if a different border was detected than the current else false
 		///
-		template <typename Pixel_T>
-		bool process(const Image<Pixel_T> & image)
+		template <typename Image_T>
+		bool process(const Image_T & image)
 		{
+			// only detect on every n-th frame
+			if (++_frameCnt < _detectionInterval)
+			{
+				return false;
+			}
+			_frameCnt = 0;
+
 			// get the border for the single image
 			BlackBorder imageBorder = _detector.process(image);
 			// add blur to the border
@@ -83,6 +103,12 @@ namespace hyperion
 		/// The number of pixels to increase a detected border for removing blury pixels
 		unsigned _blurRemoveCnt;
 
+		/// The number of frames between two detections
+		const unsigned _detectionInterval;
+
+		/// The number of frames since the last detection
+		unsigned _frameCnt;
+
 		/// The blackborder detector
 		BlackBorderDetector _detector;
 
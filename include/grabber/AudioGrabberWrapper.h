@@ -6,6 +6,7 @@
 // Hyperion includes
 #include <hyperion/Hyperion.h>
 #include <hyperion/ImageProcessor.h>
+#include <hyperion/LedFrameChannel.h>
 
 // Grabber includes
 #include <grabber/AudioGrabber.h>
@@ -30,17 +31,11 @@ public slots:
 
 	void stop();
 
-signals:
-	void emitColors(int priority, const std::vector<ColorRgb> &ledColors, const int timeout_ms);
-
 private slots:
 
 void checkSources();
 
 private:
-	/// The timeout of the led colors [ms]
-	const int _timeout_ms;
-
 	/// The priority of the led colors
 	const int _priority;
 
@@ -50,9 +45,9 @@ private:
 	/// The Hyperion instance
 	Hyperion * _hyperion;
 
-	/// The list with computed led colors
-	std::vector<ColorRgb> _ledColors;
-
 	/// Timer which tests if a higher priority source is active
 	QTimer _timer;
+
+	/// The channel through which the led colors are handed over to Hyperion
+	LedFrameChannel _channel;
 };
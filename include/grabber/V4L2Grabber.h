@@ -1,6 +1,8 @@
 #pragma once
 
 // stl includes
+#include <atomic>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -10,6 +12,7 @@
 
 // util includes
 #include <utils/Image.h>
+#include <utils/YuvImage.h>
 #include <utils/ColorRgb.h>
 #include <utils/VideoMode.h>
 
@@ -35,6 +38,32 @@ public:
 			int verticalPixelDecimation);
 	virtual ~V4L2Grabber();
 
+	///
+	/// Enables or disables the dedicated capture thread. With the capture thread the frames are
+	/// dequeued, processed and emitted on that thread instead of on the event loop of the grabber.
+	/// Can only be changed while the grabber is stopped.
+	///
+	/// @param enable True to use a capture thread
+	///
+	void setCaptureThread(bool enable);
+
+	///
+	/// Removes a black border from the emitted frames, so the black bars are no longer converted.
+	/// The crop is given in pixels of the emitted (cropped and decimated) frames and is reset when
+	/// the capture is renegotiated. The crop is limited so at least one row and one column remain;
+	/// the getters return the applied crop. Must be called from the thread which emits the frames.
+	///
+	/// @param rows The number of rows to remove at the top and at the bottom
+	/// @param columns The number of columns to remove at the left and at the right
+	///
+	void setBorderCrop(int rows, int columns);
+
+	/// @return The number of rows removed at the top and at the bottom by the border crop
+	int getBorderCropRows() const;
+
+	/// @return The number of columns removed at the left and at the right by the border crop
+	int getBorderCropColumns() const;
+
 public slots:
 	void setCropping(int cropLeft,
 					 int cropRight,
@@ -55,6 +84,14 @@ public slots:
 signals:
 	void newFrame(const Image<ColorRgb> & image);
 
+	/// Emitted instead of newFrame for YUYV and UYVY frames when connected. The view refers to the
+	/// capture buffer, which is only valid during the emit, so only direct connections can be used.
+	void newYuvFrame(const YuvImage & image);
+
+	/// Emitted (from the capture thread) when the capture thread stopped on an error. The grabber
+	/// is stopped and can be started again.
+	void captureFailed();
+
 private slots:
 	int read_frame();
 
@@ -71,16 +108,52 @@ private:
 
 	void init_device(VideoStandard videoStandard, int input);
 
+	void init_buffers(unsigned int buffer_size);
+
 	void uninit_device();
 
+	void negotiate_capture();
+
+	bool set_hardware_crop();
+
+	void set_hardware_size(bool cropped);
+
+	void set_frame_interval();
+
+	bool is_capturing() const;
+
+	///
+	/// Applies new capture settings. A running capture is stopped (and the capture thread joined)
+	/// before the settings are updated and started again with the renegotiated settings.
+	///
+	/// @param update Function which updates the settings
+	///
+	void renegotiate(const std::function<void()> & update);
+
 	void start_capturing();
 
 	void stop_capturing();
 
+	void capture_loop();
+
 	bool process_image(const void *p, int size);
 
 	void process_image(const uint8_t *p);
 
+	///
+	/// Computes the part of the frame which is sampled for the emitted frames (before the border
+	/// crop is removed)
+	///
+	/// @param xOffset The first sampled column of the frame
+	/// @param yOffset The first sampled row of the frame
+	/// @param outputWidth The number of sampled columns
+	/// @param outputHeight The number of sampled rows
+	///
+	void get_output_area(int & xOffset, int & yOffset, int & outputWidth, int & outputHeight) const;
+
+	template <typename Image_T>
+	bool check_signal(const Image_T & image);
+
 	int xioctl(int request, void *arg);
 
 	void throw_exception(const std::string &error);
@@ -109,6 +182,9 @@ private:
 	int _width;
 	int _height;
 	int _frameByteSize;
+	/// The number of bytes between two rows of the delivered frame (lines may be padded). Set by
+	/// negotiate_capture, so every change of the format has to go through the negotiation.
+	int _bytesPerLine;
 	int _cropLeft;
 	int _cropRight;
 	int _cropTop;
@@ -118,6 +194,30 @@ private:
 	int _verticalPixelDecimation;
 	int _noSignalCounterThreshold;
 
+	/// The size of the frame without hardware cropping and scaling
+	int _fullWidth;
+	int _fullHeight;
+
+	/// The default frame interval of the device (0/0 when unknown)
+	unsigned _defaultIntervalNumerator;
+	unsigned _defaultIntervalDenominator;
+
+	/// Flag indicating the hardware crop, size and frame interval have to be (re)negotiated
+	bool _negotiate;
+
+	/// The cropping and decimation which remain to be done in software after the negotiation
+	int _softwareCropLeft;
+	int _softwareCropRight;
+	int _softwareCropTop;
+	int _softwareCropBottom;
+	int _softwareHorizontalDecimation;
+	int _softwareVerticalDecimation;
+	int _softwareFrameDecimation;
+
+	/// The black border removed from the emitted frames (in pixels of the emitted frames)
+	int _borderCropRows;
+	int _borderCropColumns;
+
 	ColorRgb _noSignalThresholdColor;
 
 	VideoMode _mode3D;
@@ -126,4 +226,14 @@ private:
 	int _noSignalCounter;
 
 	QSocketNotifier * _streamNotifier;
+
+	/// Thread running the capture loop (only when a capture thread is used)
+	class CaptureThread;
+	CaptureThread * _captureThread;
+
+	/// Flag which keeps the capture loop running (cleared by the loop itself on an error)
+	std::atomic<bool> _capturing;
+
+	/// Flag indicating the stream of the capture thread is on (only used by the owning thread)
+	bool _streaming;
 };
@@ -1,11 +1,15 @@
 #pragma once
 
+// STL includes
+#include <atomic>
+
 // Qt includes
 #include <QTimer>
 
 // Hyperion includes
 #include <hyperion/Hyperion.h>
 #include <hyperion/ImageProcessor.h>
+#include <hyperion/LedFrameChannel.h>
 
 // Grabber includes
 #include <grabber/V4L2Grabber.h>
@@ -26,6 +30,7 @@ public:
 			double redSignalThreshold,
 			double greenSignalThreshold,
 			double blueSignalThreshold,
+			bool captureThread,
 			Hyperion * hyperion,
 			int hyperionPriority);
 	virtual ~V4L2Wrapper();
@@ -42,18 +47,34 @@ public slots:
 
 	void set3D(VideoMode mode);
 
-signals:
-	void emitColors(int priority, const std::vector<ColorRgb> &ledColors, const int timeout_ms);
-
 private slots:
 	void newFrame(const Image<ColorRgb> & image);
 
+	void newYuvFrame(const YuvImage & image);
+
 	void checkSources();
 
+	///
+	/// Schedules a restart of the grabber after the capture failed. The delay doubles with every
+	/// failure (up to a maximum) and is reset when a frame is received again.
+	///
+	void captureFailed();
+
 private:
-	/// The timeout of the led colors [ms]
-	const int _timeout_ms;
+	///
+	/// Shifts the border of the processor by the change of the border crop applied by the grabber.
+	/// The grabber limits the crop to the frame and resets it when the capture is renegotiated.
+	///
+	void syncBorderCrop();
+
+	///
+	/// Feeds the black border detected by the processor back to the grabber, so the grabber stops
+	/// converting the black bars. A thin margin of the border is kept in the frames, so the
+	/// detector notices when the border shrinks or disappears.
+	///
+	void cropBorder();
 
+private:
 	/// The priority of the led colors
 	const int _priority;
 
@@ -63,12 +84,22 @@ private:
 	/// The processor for transforming images to led colors
 	ImageProcessor * _processor;
 
+	/// The border crop which was last applied by the grabber (and shifted into the processor)
+	int _borderCropRows;
+	int _borderCropColumns;
+
 	/// The Hyperion instance
 	Hyperion * _hyperion;
 
-	/// The list with computed led colors
-	std::vector<ColorRgb> _ledColors;
-
 	/// Timer which tests if a higher priority source is active
 	QTimer _timer;
+
+	/// Timer which restarts the grabber after the capture failed
+	QTimer _retryTimer;
+
+	/// The delay before the next restart after a failure (0 when the last capture succeeded)
+	std::atomic<int> _retryDelay_ms;
+
+	/// The channel through which the computed led colors are handed over to Hyperion
+	LedFrameChannel _channel;
 };
@@ -6,6 +6,7 @@
 // QT includes
 #include <QObject>
 #include <QTimer>
+#include <QElapsedTimer>
 
 // hyperion-utils includes
 #include <utils/Image.h>
@@ -24,6 +25,8 @@ class EffectEngine;
 class HsvTransform;
 class RgbChannelTransform;
 class MultiColorTransform;
+class LedFrameChannel;
+class LedDelayLine;
 
 ///
 /// The main class of Hyperion. This gives other 'users' access to the attached LedDevice through
@@ -58,6 +61,9 @@ public:
 		ORDER_RGB, ORDER_RBG, ORDER_GRB, ORDER_BRG, ORDER_GBR, ORDER_BGR
 	};
 
+	/// Function which puts the color bytes of all leds in the order of the device
+	typedef void (*ColorOrderFunction)(std::vector<ColorRgb> & ledColors);
+
 	///
 	/// Constructs the Hyperion instance based on the given Json configuration
 	///
@@ -97,6 +103,38 @@ public:
 	/// @return The list of available effects
 	const std::list<EffectDefinition> &getEffects() const;
 
+	///
+	/// Returns the delay of the last led values written by the latency compensation delay line
+	///
+	/// @return The achieved delay [ms] (-1 without delay line or when nothing was written yet)
+	///
+	int getAchievedDelay() const;
+
+	///
+	/// Writes the given colors to all leds for the given time and priority, taking over the buffer
+	/// of the colors. The previous colors of the priority channel are handed back in ledColors.
+	///
+	/// @param[in] priority The priority of the written colors
+	/// @param[in,out] ledColors The colors to write to the leds
+	/// @param[in] timeout_ms The time the leds are set to the given colors [ms]
+	///
+	void setColors(int priority, std::vector<ColorRgb> &&ledColors, const int timeout_ms, bool clearEffects = true);
+
+	///
+	/// Registers a channel through which a source hands over its led colors. The newest colors of
+	/// the channel are taken when the leds are rendered.
+	///
+	/// @param[in] channel The channel (ownership is not transferred)
+	///
+	void registerChannel(LedFrameChannel * channel);
+
+	///
+	/// Unregisters a channel registered with registerChannel
+	///
+	/// @param[in] channel The channel
+	///
+	void unregisterChannel(LedFrameChannel * channel);
+
 public slots:
 	///
 	/// Writes a single color to all the leds for the given time and priority
@@ -159,6 +197,7 @@ public slots:
 
 public:
 	static ColorOrder createColorOrder(const Json::Value & deviceConfig);
+	static ColorOrderFunction createColorOrderFunction(const ColorOrder colorOrder);
 	static LedString createLedString(const Json::Value & ledsConfig);
 
 	static MultiColorTransform * createLedColorsTransform(const unsigned ledCnt, const Json::Value & colorTransformConfig);
@@ -166,6 +205,10 @@ public:
 	static HsvTransform * createHsvTransform(const Json::Value & hsvConfig);
 	static RgbChannelTransform * createRgbChannelTransform(const Json::Value& colorConfig);
 
+	static qint64 createRenderInterval(const Json::Value & deviceConfig);
+
+	static int64_t createTimeoutTime(const int timeout_ms);
+
 	static LedDevice * createColorSmoothing(const Json::Value & smoothingConfig, LedDevice * ledDevice);
 
 signals:
@@ -184,6 +227,30 @@ private slots:
 	///
 	void update();
 
+	///
+	/// Handles a tick of the render clock; writes the leds when they changed since the last write
+	///
+	void renderTick();
+
+	///
+	/// Handles the notification of a channel that it published new led colors
+	///
+	void consumeChannels();
+
+private:
+	///
+	/// Takes the newest colors of all channels into the priority muxer
+	///
+	/// @return True if colors of the current priority (or a higher one) were taken
+	///
+	bool takeChannels();
+
+	///
+	/// Requests the leds to be (re)written. Without render clock the leds are written immediately,
+	/// otherwise the request is combined with other requests until the next tick of the clock.
+	///
+	void requestUpdate();
+
 private:
 	/// The specifiation of the led frame construction and picture integration
 	LedString _ledString;
@@ -197,12 +264,42 @@ private:
 	/// Value with the desired color byte order
 	ColorOrder _colorOrder;
 
+	/// The function reordering the color bytes, specialised for the desired color byte order
+	const ColorOrderFunction _colorOrderFunction;
+
+	/// The led colors written to the device; one is filled while the other holds the previous write
+	std::vector<ColorRgb> _ledBuffers[2];
+
+	/// The index of the led buffer which is filled by the next update
+	unsigned _ledBuffer;
+
 	/// The actual LedDevice
 	LedDevice * _device;
 
+	/// The latency compensation delay line in front of the device (nullptr if not configured)
+	LedDelayLine * _delayLine;
+
 	/// Effect engine
 	EffectEngine * _effectEngine;
 
+	/// The registered channels handing over led colors
+	std::vector<LedFrameChannel *> _channels;
+
 	/// The timer for handling priority channel timeouts
 	QTimer _timer;
+
+	/// The minimal interval between two writes to the device [ns] (0 = render clock disabled)
+	const qint64 _renderInterval_ns;
+
+	/// The monotonic clock of the render clock
+	QElapsedTimer _renderClock;
+
+	/// The time of the last write to the device according to the render clock [ns]
+	qint64 _lastRender_ns;
+
+	/// The timer for the next tick of the render clock
+	QTimer _renderTimer;
+
+	/// Flag indicating the leds changed since the last write to the device
+	bool _renderDirty;
 };
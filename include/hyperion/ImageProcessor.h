@@ -3,11 +3,14 @@
 
 // Utils includes
 #include <utils/Image.h>
+#include <utils/ImageView.h>
+#include <utils/YuvImage.h>
 
 // Hyperion includes
 #include <hyperion/ImageProcessorFactory.h>
 #include <hyperion/LedString.h>
 #include <hyperion/ImageToLedsMap.h>
+#include <hyperion/ImageToLedsMapCache.h>
 
 // Black border includes
 #include <blackborder/BlackBorderProcessor.h>
@@ -40,16 +43,34 @@ public:
 	/// Enable or disable the black border detector
 	void enableBalckBorderDetector(bool enable);
 
+	///
+	/// Returns the black border currently removed from the processed images (unknown when the
+	/// black border detector is disabled)
+	///
+	/// @return The current border
+	///
+	hyperion::BlackBorder getCurrentBorder() const;
+
+	///
+	/// Informs the processor that the source of the images removes (or restores) part of the
+	/// current black border. The border and the mapping are shifted accordingly, so the next
+	/// (smaller or larger) image is processed without detecting the border again.
+	///
+	/// @param[in] horizontalShift  The number of rows removed at the top and at the bottom
+	/// @param[in] verticalShift  The number of columns removed at the left and at the right
+	///
+	void shiftBorder(int horizontalShift, int verticalShift);
+
 	///
 	/// Processes the image to a list of led colors. This will update the size of the buffer-image
 	/// if required and call the image-to-leds mapping to determine the mean color per led.
 	///
-	/// @param[in] image  The image to translate to led values
+	/// @param[in] image  The image (or view on an image) to translate to led values
 	///
 	/// @return The color value per led
 	///
-	template <typename Pixel_T>
-	std::vector<ColorRgb> process(const Image<Pixel_T>& image)
+	template <typename Image_T>
+	std::vector<ColorRgb> process(const Image_T& image)
 	{
 		// Ensure that the buffer-image is the proper size
 		setSize(image.width(), image.height());
@@ -58,20 +79,22 @@ public:
 		verifyBorder(image);
 
 		// Create a result vector and call the 'in place' functionl
-		std::vector<ColorRgb> colors = _imageToLeds->getMeanLedColor(image);
+		std::vector<ColorRgb> colors(_ledString.leds().size(), ColorRgb::BLACK);
+		_imageToLeds->getMeanLedColor(image, colors, _integralImage);
 
 		// return the computed colors
 		return colors;
 	}
 
 	///
-	/// Determines the led colors of the image in the buffer.
+	/// Determines the led colors of the image in the buffer. A view (ImageView) is processed where
+	/// the image is in memory, without copying it.
 	///
-	/// @param[in] image  The image to translate to led values
+	/// @param[in] image  The image (or view on an image) to translate to led values
 	/// @param[out] ledColors  The color value per led
 	///
-	template <typename Pixel_T>
-	void process(const Image<Pixel_T>& image, std::vector<ColorRgb>& ledColors)
+	template <typename Image_T>
+	void process(const Image_T& image, std::vector<ColorRgb>& ledColors)
 	{
 		// Ensure that the buffer-image is the proper size
 		setSize(image.width(), image.height());
@@ -80,9 +103,17 @@ public:
 		verifyBorder(image);
 
 		// Determine the mean-colors of each led (using the existing mapping)
-		_imageToLeds->getMeanLedColor(image, ledColors);
+		_imageToLeds->getMeanLedColor(image, ledColors, _integralImage);
 	}
 
+	///
+	/// Determines the led colors directly from a captured yuv frame, without converting the frame.
+	///
+	/// @param[in] image  The view on the frame to translate to led values
+	/// @param[out] ledColors  The color value per led
+	///
+	void process(const YuvImage & image, std::vector<ColorRgb>& ledColors);
+
 	///
 	/// Get the hscan and vscan parameters for a single led
 	///
@@ -103,18 +134,23 @@ private:
 	/// given led-string specification
 	///
 	/// @param[in] ledString  The led-string specification
+	/// @param[in] ledRevision  The revision of the led-string specification (identifies the shared mappings)
 	/// @param[in] enableBlackBorderDetector Flag indicating if the blacborder detector should be enabled
 	/// @param[in] blackborderThreshold The threshold which the blackborder detector should use
+	/// @param[in] blackborderInterval The number of frames between two black-border detections
+	/// @param[in] mappingEngine The algorithm used to compute the mean color per led
+	/// @param[in] mappingThreads The maximum number of threads used to compute the mean colors (0=number of cores)
+	/// @param[in] mappingSamples The maximum number of pixels read per led (0=all pixels)
 	///
-	ImageProcessor(const LedString &ledString, bool enableBlackBorderDetector, uint8_t blackborderThreshold);
+	ImageProcessor(const LedString &ledString, unsigned ledRevision, bool enableBlackBorderDetector, uint8_t blackborderThreshold, unsigned blackborderInterval, MappingEngine mappingEngine, unsigned mappingThreads, unsigned mappingSamples);
 
 	///
 	/// Performs black-border detection (if enabled) on the given image
 	///
-	/// @param[in] image  The image to perform black-border detection on
+	/// @param[in] image  The image (or view on a frame) to perform black-border detection on
 	///
-	template <typename Pixel_T>
-	void verifyBorder(const Image<Pixel_T> & image)
+	template <typename Image_T>
+	void verifyBorder(const Image_T & image)
 	{
 		if(_enableBlackBorderRemoval && _borderProcessor->process(image))
 		{
@@ -122,34 +158,58 @@ private:
 
 			const hyperion::BlackBorder border = _borderProcessor->getCurrentBorder();
 
-			// Clean up the old mapping
-			delete _imageToLeds;
-
 			if (border.unknown)
 			{
-				// Construct a new buffer and mapping
-				_imageToLeds = new hyperion::ImageToLedsMap(image.width(), image.height(), 0, 0, _ledString.leds());
+				// Switch to the (shared) mapping without borders
+				_imageToLeds = getMap(image.width(), image.height(), 0, 0);
 			}
 			else
 			{
-				// Construct a new buffer and mapping
-				_imageToLeds = new hyperion::ImageToLedsMap(image.width(), image.height(), border.horizontalSize, border.verticalSize, _ledString.leds());
+				// Switch to the (shared) mapping with the detected borders
+				_imageToLeds = getMap(image.width(), image.height(), border.horizontalSize, border.verticalSize);
 			}
 
 			std::cout << "CURRENT BORDER TYPE: unknown=" << border.unknown << " hor.size=" << border.horizontalSize << " vert.size=" << border.verticalSize << std::endl;
 		}
 	}
 
+	///
+	/// Obtains the mapping for the given image size and borders from the process-wide cache
+	///
+	/// @param[in] width  The width of the image
+	/// @param[in] height  The height of the image
+	/// @param[in] horizontalBorder  The size of the horizontal border
+	/// @param[in] verticalBorder  The size of the vertical border
+	///
+	/// @return The shared mapping
+	///
+	std::shared_ptr<const hyperion::ImageToLedsMap> getMap(const unsigned width, const unsigned height, const unsigned horizontalBorder, const unsigned verticalBorder) const;
+
 private:
 	/// The Led-string specification
 	const LedString _ledString;
 
+	/// The revision of the Led-string specification
+	const unsigned _ledRevision;
+
 	/// Flag the enables(true)/disabled(false) blackborder detector
 	bool _enableBlackBorderRemoval;
 
 	/// The processor for black border detection
 	hyperion::BlackBorderProcessor * _borderProcessor;
 
-	/// The mapping of image-pixels to leds
-	hyperion::ImageToLedsMap* _imageToLeds;
+	/// The algorithm used to compute the mean color per led
+	const MappingEngine _mappingEngine;
+
+	/// The maximum number of threads used to compute the mean colors
+	const unsigned _mappingThreads;
+
+	/// The maximum number of pixels read per led
+	const unsigned _mappingSamples;
+
+	/// The mapping of image-pixels to leds (shared with all processors using the same image size)
+	std::shared_ptr<const hyperion::ImageToLedsMap> _imageToLeds;
+
+	/// The integral image buffer used by the mapping (owned by the processor as the mapping is shared)
+	std::vector<uint32_t> _integralImage;
 };
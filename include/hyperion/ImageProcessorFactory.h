@@ -7,6 +7,7 @@
 #include <json/json.h>
 
 #include <hyperion/LedString.h>
+#include <hyperion/MappingEngine.h>
 
 // Forward class declaration
 class ImageProcessor;
@@ -27,13 +28,18 @@ public:
 
 public:
 	///
-	/// Initialises this factory with the given led-configuration
+	/// Initialises this factory with the given led-configuration. Every call starts a new revision
+	/// of the led-configuration, so mappings of earlier configurations are not shared anymore.
 	///
 	/// @param[in] ledString  The led configuration
 	/// @param[in] enableBlackBorderDetector Flag indicating if the blacborder detector should be enabled
 	/// @param[in] blackborderThreshold The threshold which the blackborder detector should use
+	/// @param[in] blackborderInterval The number of frames between two black-border detections
+	/// @param[in] mappingEngine The algorithm used to compute the mean color per led
+	/// @param[in] mappingThreads The maximum number of threads used to compute the mean colors (0=number of cores)
+	/// @param[in] mappingSamples The maximum number of pixels read per led (0=all pixels)
 	///
-	void init(const LedString& ledString, bool enableBlackBorderDetector, double blackborderThreshold);
+	void init(const LedString& ledString, bool enableBlackBorderDetector, double blackborderThreshold, unsigned blackborderInterval, MappingEngine mappingEngine, unsigned mappingThreads, unsigned mappingSamples);
 
 	///
 	/// Creates a new ImageProcessor. The onwership of the processor is transferred to the caller.
@@ -46,9 +52,24 @@ private:
 	/// The Led-string specification
 	LedString _ledString;
 
+	/// The revision of the Led-string specification (incremented on each init)
+	unsigned _ledRevision;
+
 	/// Flag indicating if the black border detector should be used
 	bool _enableBlackBorderDetector;
 
 	/// Threshold for the blackborder detector [0 .. 255]
 	uint8_t _blackborderThreshold;
+
+	/// The number of frames between two black-border detections
+	unsigned _blackborderInterval;
+
+	/// The algorithm used to compute the mean color per led
+	MappingEngine _mappingEngine;
+
+	/// The maximum number of threads used to compute the mean colors
+	unsigned _mappingThreads;
+
+	/// The maximum number of pixels read per led
+	unsigned _mappingSamples;
 };
@@ -1,21 +1,25 @@
-
 #pragma once
 
 // STL includes
 #include <cassert>
 #include <sstream>
+#include <functional>
 
 // hyperion-utils includes
 #include <utils/Image.h>
+#include <utils/ImageView.h>
+#include <utils/PixelSum.h>
+#include <utils/YuvImage.h>
 
 // hyperion includes
 #include <hyperion/LedString.h>
+#include <hyperion/MappingEngine.h>
 
 namespace hyperion
 {
 
 	///
-	/// The ImageToLedsMap holds a mapping of indices into an image to leds. It can be used to
+	/// The ImageToLedsMap holds a mapping of image regions to leds. It can be used to
 	/// calculate the average (or mean) color per led for a specific region.
 	///
 	class ImageToLedsMap
@@ -23,9 +27,9 @@ namespace hyperion
 	public:
 
 		///
-		/// Constructs an mapping from the absolute indices in an image to each led based on the border
-		/// definition given in the list of leds. The map holds absolute indices to any given image,
-		/// provided that it is row-oriented.
+		/// Constructs an mapping from the rows of an image to each led based on the border
+		/// definition given in the list of leds. The map holds for each led a list of row spans
+		/// into any given image, provided that it is row-oriented.
 		/// The mapping is created purely on size (width and height). The given borders are excluded
 		/// from indexing.
 		///
@@ -34,13 +38,21 @@ namespace hyperion
 		/// @param[in] horizontalBorder The size of the horizontal border (0=no border)
 		/// @param[in] verticalBorder   The size of the vertical border (0=no border)
 		/// @param[in] leds             The list with led specifications
+		/// @param[in] engine           The algorithm used to compute the mean colors
+		/// @param[in] threadCount      The maximum number of threads used to compute the mean colors
+		///                             (0=number of cores)
+		/// @param[in] sampleCount      The maximum number of pixels read per led (0=all pixels); not
+		///                             used by the integral image engine
 		///
 		ImageToLedsMap(
 				const unsigned width,
 				const unsigned height,
 				const unsigned horizontalBorder,
 				const unsigned verticalBorder,
-				const std::vector<Led> & leds);
+				const std::vector<Led> & leds,
+				const MappingEngine engine = MAPPINGENGINE_AUTO,
+				const unsigned threadCount = 1,
+				const unsigned sampleCount = 0);
 
 		///
 		/// Returns the width of the indexed image
@@ -56,85 +68,312 @@ namespace hyperion
 		///
 		unsigned height() const;
 
+		///
+		/// Returns if the mean colors are computed using an integral image (summed-area table)
+		///
+		/// @return True if the integral image engine is used, false if the regions are summed directly
+		///
+		bool usesIntegralImage() const;
+
+		///
+		/// Returns the number of shards in which the leds are processed in parallel
+		///
+		/// @return The number of shards (1 when the leds are processed on the calling thread only)
+		///
+		unsigned shardCount() const;
+
 		///
 		/// Determines the mean-color for each led using the mapping the image given
 		/// at construction.
 		///
-		/// @param[in] image  The image from which to extract the led colors
+		/// @param[in] image  The image (or view on an image) from which to extract the led colors
 		///
 		/// @return ledColors  The vector containing the output
 		///
-		template <typename Pixel_T>
-		std::vector<ColorRgb> getMeanLedColor(const Image<Pixel_T> & image) const
+		template <typename Image_T>
+		std::vector<ColorRgb> getMeanLedColor(const Image_T & image) const
 		{
-			std::vector<ColorRgb> colors(mColorsMap.size(), ColorRgb{0,0,0});
+			std::vector<ColorRgb> colors(_ledRegions.size(), ColorRgb{0,0,0});
 			getMeanLedColor(image, colors);
 			return colors;
 		}
 
 		///
 		/// Determines the mean color for each led using the mapping the image given
-		/// at construction.
+		/// at construction. Without a (reusable) buffer for the integral image the regions are
+		/// always summed directly, so no memory is allocated per image.
+		///
+		/// @param[in] image  The image (or view on an image) from which to extract the led colors
+		/// @param[out] ledColors  The vector containing the output
+		///
+		template <typename Image_T>
+		void getMeanLedColor(const Image_T & image, std::vector<ColorRgb> & ledColors) const
+		{
+			// Sanity check for the number of leds
+			assert(_ledRegions.size() == ledColors.size());
+
+			getMeanLedColorDirect(ImageView<typename Image_T::pixel_type>(image), ledColors);
+		}
+
+		///
+		/// Determines the mean color for each led using the mapping the image given
+		/// at construction. The map itself is not modified, so it can be shared by multiple threads;
+		/// the buffer for the integral image is supplied by the caller so it can be reused.
 		///
 		/// @param[in] image  The image from which to extract the led colors
 		/// @param[out] ledColors  The vector containing the output
+		/// @param[in,out] integralImage  Buffer for the integral image (only used by the integral image engine)
 		///
 		template <typename Pixel_T>
-		void getMeanLedColor(const Image<Pixel_T> & image, std::vector<ColorRgb> & ledColors) const
+		void getMeanLedColor(const Image<Pixel_T> & image, std::vector<ColorRgb> & ledColors, std::vector<uint32_t> & integralImage) const
+		{
+			getMeanLedColor(ImageView<Pixel_T>(image), ledColors, integralImage);
+		}
+
+		///
+		/// Determines the mean color for each led using the mapping from a view on an image, which
+		/// is read where it is in memory.
+		///
+		/// @param[in] image  The view on the image from which to extract the led colors
+		/// @param[out] ledColors  The vector containing the output
+		/// @param[in,out] integralImage  Buffer for the integral image (only used by the integral image engine)
+		///
+		template <typename Pixel_T>
+		void getMeanLedColor(const ImageView<Pixel_T> & image, std::vector<ColorRgb> & ledColors, std::vector<uint32_t> & integralImage) const
 		{
 			// Sanity check for the number of leds
-			assert(mColorsMap.size() == ledColors.size());
+			assert(_ledRegions.size() == ledColors.size());
 
-			// Iterate each led and compute the mean
-			auto led = ledColors.begin();
-			for (auto ledColors = mColorsMap.begin(); ledColors != mColorsMap.end(); ++ledColors, ++led)
+			if (_useIntegralImage)
 			{
-				const ColorRgb color = calcMeanColor(image, *ledColors);
-				*led = color;
+				getMeanLedColorIntegral(image, ledColors, integralImage);
+				return;
 			}
+
+			getMeanLedColorDirect(image, ledColors);
 		}
 
+		///
+		/// Determines the mean color for each led directly from a captured yuv frame. The luma and
+		/// chroma are averaged per led and only the mean is converted to rgb, so only the pixels
+		/// covered by a led are read (and none are converted).
+		///
+		/// @param[in] image  The view on the frame from which to extract the led colors
+		/// @param[out] ledColors  The vector containing the output
+		///
+		void getMeanLedColor(const YuvImage & image, std::vector<ColorRgb> & ledColors) const;
+
 	private:
+		///
+		/// Determines the mean color for each led by summing the regions directly (on the worker pool
+		/// when the leds are sharded)
+		///
+		/// @param[in] image  The view on the image from which to extract the led colors
+		/// @param[out] ledColors  The vector containing the output
+		///
+		template <typename Pixel_T>
+		void getMeanLedColorDirect(const ImageView<Pixel_T> & image, std::vector<ColorRgb> & ledColors) const
+		{
+			if (_shardLeds.size() > 2)
+			{
+				// Process the shards on the worker pool
+				runShards([&](unsigned shard){ getMeanLedColor(image, ledColors, _shardLeds[shard], _shardLeds[shard+1]); });
+				return;
+			}
+
+			getMeanLedColor(image, ledColors, 0, _ledRegions.size());
+		}
+
+		///
+		/// Determines the mean color for the given range of leds from a captured yuv frame
+		///
+		/// @param[in] image  The view on the frame from which to extract the led colors
+		/// @param[out] ledColors  The vector containing the output
+		/// @param[in] firstLed  The first led of the range
+		/// @param[in] endLed  The led one past the last led of the range
+		///
+		void getMeanLedColor(const YuvImage & image, std::vector<ColorRgb> & ledColors, unsigned firstLed, unsigned endLed) const;
+
+		///
+		/// Determines the mean color for the given range of leds
+		///
+		/// @param[in] image  The view on the image from which to extract the led colors
+		/// @param[out] ledColors  The vector containing the output
+		/// @param[in] firstLed  The first led of the range
+		/// @param[in] endLed  The led one past the last led of the range
+		///
+		template <typename Pixel_T>
+		void getMeanLedColor(const ImageView<Pixel_T> & image, std::vector<ColorRgb> & ledColors, unsigned firstLed, unsigned endLed) const
+		{
+			// Iterate each led and compute the mean
+			for (unsigned led = firstLed; led < endLed; ++led)
+			{
+				ledColors[led] = calcMeanColor(image, _ledRegions[led]);
+			}
+		}
+
+		///
+		/// Executes the given work for each shard. The shards are distributed over a process-wide
+		/// worker pool; the calling thread processes the first shard itself and returns when all
+		/// shards are finished.
+		///
+		/// @param[in] work  The work to execute for a single shard
+		///
+		void runShards(const std::function<void(unsigned)> & work) const;
+
+		///
+		/// A horizontal run of pixels [xBegin, xEnd) on a single row of the image
+		///
+		struct PixelSpan
+		{
+			/// The row of the span
+			unsigned row;
+			/// The first column of the span
+			unsigned xBegin;
+			/// The column one past the last column of the span
+			unsigned xEnd;
+		};
+
+		///
+		/// The part of the span list that belongs to a single led
+		///
+		struct LedRegion
+		{
+			/// Index of the first span of the led
+			unsigned firstSpan;
+			/// The number of spans of the led
+			unsigned spanCount;
+			/// The total number of pixels read from the spans
+			unsigned pixelCount;
+			/// The distance between the pixels read from each span (1 when all pixels are read)
+			unsigned step;
+
+			/// The complete rectangle of the led [xBegin, xEnd) x [yBegin, yEnd)
+			unsigned xBegin;
+			unsigned xEnd;
+			unsigned yBegin;
+			unsigned yEnd;
+		};
+
 		/// The width of the indexed image
 		const unsigned _width;
 		/// The height of the indexed image
 		const unsigned _height;
-		/// The absolute indices into the image for each led
-		std::vector<std::vector<unsigned>> mColorsMap;
+		/// The row spans of all leds (grouped per led)
+		std::vector<PixelSpan> _spans;
+		/// The region in the span list for each led
+		std::vector<LedRegion> _ledRegions;
+		/// The first led of each shard followed by the number of leds (empty when not sharded)
+		std::vector<unsigned> _shardLeds;
+		/// Flag indicating that the integral image engine is used
+		bool _useIntegralImage;
+
+		///
+		/// Determines the mean color for each led using a summed-area table of the image. The table
+		/// is built once for the image after which the mean of each led region takes four lookups
+		/// per channel, independent of the size (and overlap) of the led regions.
+		///
+		/// @param[in] image  The view on the image from which to extract the led colors
+		/// @param[out] ledColors  The vector containing the output
+		/// @param[in,out] integralImage  Buffer for the per-channel summed-area table ((width+1)*(height+1)*3)
+		///
+		template <typename Pixel_T>
+		void getMeanLedColorIntegral(const ImageView<Pixel_T> & image, std::vector<ColorRgb> & ledColors, std::vector<uint32_t> & integralImage) const
+		{
+			const unsigned width = image.width();
+			const unsigned height = image.height();
+			const unsigned stride = (width + 1) * 3;
+
+			// Build the table; the first row and column remain zero
+			integralImage.resize(stride * (height + 1));
+			std::fill(integralImage.begin(), integralImage.begin() + stride, 0);
+			for (unsigned y = 0; y < height; ++y)
+			{
+				const Pixel_T * pixel = image.row(y);
+				const uint32_t * above = integralImage.data() + y * stride;
+				uint32_t * current = integralImage.data() + (y + 1) * stride;
+
+				uint32_t rowRed   = 0;
+				uint32_t rowGreen = 0;
+				uint32_t rowBlue  = 0;
+				current[0] = current[1] = current[2] = 0;
+				for (unsigned x = 0; x < width; ++x, ++pixel)
+				{
+					rowRed   += pixel->red;
+					rowGreen += pixel->green;
+					rowBlue  += pixel->blue;
+
+					const unsigned index = (x + 1) * 3;
+					current[index    ] = above[index    ] + rowRed;
+					current[index + 1] = above[index + 1] + rowGreen;
+					current[index + 2] = above[index + 2] + rowBlue;
+				}
+			}
+
+			auto led = ledColors.begin();
+			for (auto region = _ledRegions.begin(); region != _ledRegions.end(); ++region, ++led)
+			{
+				if (region->pixelCount == 0)
+				{
+					*led = ColorRgb::BLACK;
+					continue;
+				}
+
+				const uint32_t * top    = integralImage.data() + region->yBegin * stride;
+				const uint32_t * bottom = integralImage.data() + region->yEnd * stride;
+				const unsigned left  = region->xBegin * 3;
+				const unsigned right = region->xEnd * 3;
+				const unsigned area  = (region->xEnd - region->xBegin) * (region->yEnd - region->yBegin);
+
+				uint8_t mean[3];
+				for (unsigned channel = 0; channel < 3; ++channel)
+				{
+					const uint32_t sum = bottom[right + channel] - bottom[left + channel] - top[right + channel] + top[left + channel];
+					mean[channel] = uint8_t(sum / area);
+				}
+				*led = ColorRgb{mean[0], mean[1], mean[2]};
+			}
+		}
 
 		///
-		/// Calculates the 'mean color' of the given list. This is the mean over each color-channel
+		/// Calculates the 'mean color' of the given region. This is the mean over each color-channel
 		/// (red, green, blue)
 		///
-		/// @param[in] image The image a section from which an average color must be computed
-		/// @param[in] colors  The list with colors
+		/// @param[in] image The view on the image a section from which an average color must be computed
+		/// @param[in] region The region of the led
 		///
-		/// @return The mean of the given list of colors (or black when empty)
+		/// @return The mean of the given region (or black when empty)
 		///
 		template <typename Pixel_T>
-		ColorRgb calcMeanColor(const Image<Pixel_T> & image, const std::vector<unsigned> & colors) const
+		ColorRgb calcMeanColor(const ImageView<Pixel_T> & image, const LedRegion & region) const
 		{
-			if (colors.size() == 0)
+			if (region.pixelCount == 0)
 			{
 				return ColorRgb::BLACK;
 			}
 
-			// Accumulate the sum of each seperate color channel
-			uint_fast16_t cummRed   = 0;
-			uint_fast16_t cummGreen = 0;
-			uint_fast16_t cummBlue  = 0;
-			for (const unsigned colorOffset : colors)
+			// Accumulate the sum of each seperate color channel (vectorised for rgb and rgba pixels)
+			ChannelSums sums = {0, 0, 0};
+
+			const PixelSpan * span = _spans.data() + region.firstSpan;
+			const PixelSpan * spanEnd = span + region.spanCount;
+			for (; span != spanEnd; ++span)
 			{
-				const Pixel_T& pixel = image.memptr()[colorOffset];
-				cummRed   += pixel.red;
-				cummGreen += pixel.green;
-				cummBlue  += pixel.blue;
+				const Pixel_T * pixel = image.row(span->row) + span->xBegin;
+				if (region.step == 1)
+				{
+					sumPixels(pixel, span->xEnd - span->xBegin, sums);
+				}
+				else
+				{
+					sumPixelsStrided(pixel, (span->xEnd - span->xBegin + region.step - 1) / region.step, region.step, sums);
+				}
 			}
 
 			// Compute the average of each color channel
-			const uint8_t avgRed   = uint8_t(cummRed/colors.size());
-			const uint8_t avgGreen = uint8_t(cummGreen/colors.size());
-			const uint8_t avgBlue  = uint8_t(cummBlue/colors.size());
+			const uint8_t avgRed   = uint8_t(sums.red/region.pixelCount);
+			const uint8_t avgGreen = uint8_t(sums.green/region.pixelCount);
+			const uint8_t avgBlue  = uint8_t(sums.blue/region.pixelCount);
 
 			// Return the computed color
 			return {avgRed, avgGreen, avgBlue};
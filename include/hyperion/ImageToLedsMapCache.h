@@ -0,0 +1,120 @@
+#pragma once
+
+// STL includes
+#include <list>
+#include <memory>
+#include <vector>
+
+// QT includes
+#include <QMutex>
+
+// hyperion includes
+#include <hyperion/ImageToLedsMap.h>
+#include <hyperion/LedString.h>
+#include <hyperion/MappingEngine.h>
+
+namespace hyperion
+{
+
+	///
+	/// The ImageToLedsMapCache is a process-wide cache of image-to-leds mappings. All ImageProcessors
+	/// (grabbers, effects, proto and json clients) that process images of the same size with the same
+	/// borders share a single (immutable) mapping instead of each building their own.
+	///
+	/// Mappings that are still in use are never evicted; of the unused mappings the least recently
+	/// used ones are dropped when the cache holds more than its capacity.
+	///
+	class ImageToLedsMapCache
+	{
+	public:
+		///
+		/// Returns the 'singleton' instance (creates the singleton if it does not exist)
+		///
+		/// @return The singleton instance of the ImageToLedsMapCache
+		///
+		static ImageToLedsMapCache& getInstance();
+
+		///
+		/// Returns the mapping for the given image size and borders, constructing it when it is not
+		/// cached yet. The returned mapping is shared and may be used by multiple threads at once.
+		///
+		/// @param[in] width            The width of the indexed image
+		/// @param[in] height           The height of the indexed image
+		/// @param[in] horizontalBorder The size of the horizontal border (0=no border)
+		/// @param[in] verticalBorder   The size of the vertical border (0=no border)
+		/// @param[in] leds             The list with led specifications
+		/// @param[in] ledRevision      The revision of the led specifications; mappings of other
+		///                             revisions are never returned
+		/// @param[in] engine           The algorithm used to compute the mean colors
+		/// @param[in] threadCount      The maximum number of threads used to compute the mean colors
+		/// @param[in] sampleCount      The maximum number of pixels read per led (0=all pixels)
+		///
+		/// @return The (shared) mapping
+		///
+		std::shared_ptr<const ImageToLedsMap> getMap(
+				const unsigned width,
+				const unsigned height,
+				const unsigned horizontalBorder,
+				const unsigned verticalBorder,
+				const std::vector<Led> & leds,
+				const unsigned ledRevision,
+				const MappingEngine engine,
+				const unsigned threadCount,
+				const unsigned sampleCount);
+
+		///
+		/// Drops all mappings which are not in use anymore
+		///
+		void clear();
+
+	private:
+		///
+		/// Constructs an empty cache
+		///
+		/// @param[in] capacity The number of mappings kept in the cache when they are not in use
+		///
+		ImageToLedsMapCache(const unsigned capacity);
+
+		///
+		/// Drops the least recently used mappings which are not in use anymore, until the cache
+		/// holds no more than its capacity (or all remaining mappings are in use).
+		///
+		void evict();
+
+		///
+		/// The parameters which uniquely identify a mapping
+		///
+		struct Key
+		{
+			unsigned width;
+			unsigned height;
+			unsigned horizontalBorder;
+			unsigned verticalBorder;
+			unsigned ledRevision;
+			MappingEngine engine;
+			unsigned threadCount;
+			unsigned sampleCount;
+
+			bool operator==(const Key & other) const;
+		};
+
+		///
+		/// A cached mapping with its key
+		///
+		struct Entry
+		{
+			Key key;
+			std::shared_ptr<const ImageToLedsMap> map;
+		};
+
+		/// The number of mappings kept in the cache when they are not in use
+		const unsigned _capacity;
+
+		/// Mutex guarding the entries
+		QMutex _mutex;
+
+		/// The cached mappings, ordered from most to least recently used
+		std::list<Entry> _entries;
+	};
+
+} // end namespace hyperion
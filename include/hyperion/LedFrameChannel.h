@@ -0,0 +1,91 @@
+#pragma once
+
+// STL includes
+#include <atomic>
+#include <vector>
+
+// Utils includes
+#include <utils/ColorRgb.h>
+#include <utils/FrameRing.h>
+
+// Forward class declaration
+class Hyperion;
+
+///
+/// Preallocated channel which hands led colors from a single producer (typically a grabber,
+/// possibly on its own thread) to Hyperion. The producer computes the colors in place in the
+/// producer slot and publishes them; Hyperion takes the newest published colors when it renders
+/// the leds. Unlike a queued signal, publishing does not copy or allocate the colors: only a
+/// small notification is queued to Hyperion, and only when the previous one has been handled.
+///
+class LedFrameChannel
+{
+public:
+	///
+	/// Constructs the channel and registers it with Hyperion
+	///
+	/// @param hyperion The Hyperion instance consuming the channel
+	/// @param priority The priority of the led colors
+	/// @param timeout_ms The timeout of the led colors [ms]
+	///
+	LedFrameChannel(Hyperion * hyperion, int priority, int timeout_ms);
+
+	///
+	/// Destructor; unregisters the channel from Hyperion
+	///
+	~LedFrameChannel();
+
+	///
+	/// @return The priority of the led colors
+	///
+	int getPriority() const;
+
+	///
+	/// @return The timeout of the led colors [ms]
+	///
+	int getTimeout() const;
+
+	///
+	/// Returns the colors into which the producer computes its next led colors (sized for all leds)
+	///
+	/// @return The slot of the producer
+	///
+	std::vector<ColorRgb> & producerSlot();
+
+	///
+	/// Publishes the colors of the producer slot, replacing colors which Hyperion did not take
+	/// yet. Hyperion is notified when no notification is outstanding.
+	///
+	void publish();
+
+	///
+	/// Takes the newest published colors for Hyperion (main thread only)
+	///
+	/// @return True if new colors are available in the consumer slot
+	///
+	bool take();
+
+	///
+	/// Returns the colors last taken by Hyperion. Hyperion may swap the colors out, as long as
+	/// it leaves colors for all leds in the slot.
+	///
+	/// @return The slot of the consumer
+	///
+	std::vector<ColorRgb> & consumerSlot();
+
+private:
+	/// The Hyperion instance consuming the channel
+	Hyperion * _hyperion;
+
+	/// The priority of the led colors
+	const int _priority;
+
+	/// The timeout of the led colors [ms]
+	const int _timeout_ms;
+
+	/// The led colors handed over to Hyperion (newest wins)
+	FrameRing<std::vector<ColorRgb>> _ring;
+
+	/// Flag indicating a notification is queued to Hyperion and not yet handled
+	std::atomic<bool> _notified;
+};
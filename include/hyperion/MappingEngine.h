@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+#include <algorithm>
+
+/**
+ * Enumeration of the possible algorithms to compute the mean color of each led region
+ */
+enum MappingEngine {
+	MAPPINGENGINE_AUTO,
+	MAPPINGENGINE_DIRECT,
+	MAPPINGENGINE_INTEGRAL
+};
+
+inline MappingEngine parseMappingEngine(std::string mappingEngine)
+{
+	// convert to lower case
+	std::transform(mappingEngine.begin(), mappingEngine.end(), mappingEngine.begin(), ::tolower);
+
+	if (mappingEngine == "direct")
+	{
+		return MAPPINGENGINE_DIRECT;
+	}
+	else if (mappingEngine == "integral")
+	{
+		return MAPPINGENGINE_INTEGRAL;
+	}
+
+	// return the default AUTO
+	return MAPPINGENGINE_AUTO;
+}
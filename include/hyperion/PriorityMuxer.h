@@ -3,6 +3,8 @@
 // STL includes
 #include <vector>
 #include <map>
+#include <queue>
+#include <functional>
 #include <cstdint>
 #include <limits>
 
@@ -17,6 +19,10 @@
 /// and the muxer keeps track of all active priorities. The current priority can be queried and per
 /// priority the led colors.
 ///
+/// The priority map is ordered, so the current priority is its first key. The timeouts of the
+/// channels are kept in a min-heap, so updating the current time only visits channels which
+/// actually timed out.
+///
 class PriorityMuxer
 {
 public:
@@ -88,6 +94,17 @@ public:
 	///
 	void setInput(const int priority, const std::vector<ColorRgb>& ledColors, const int64_t timeoutTime_ms=-1);
 
+	///
+	/// Sets/Updates the data for a priority channel, taking over the buffer of the given led colors.
+	/// The previous led colors of the channel are handed back in ledColors, so the caller can reuse
+	/// that buffer for its next input without allocating.
+	///
+	/// @param[in] priority The priority of the channel
+	/// @param[in,out] ledColors The led colors of the priority channel
+	/// @param[in] timeoutTime_ms The absolute timeout time of the channel
+	///
+	void setInput(const int priority, std::vector<ColorRgb>&& ledColors, const int64_t timeoutTime_ms=-1);
+
 	///
 	/// Clears the specified priority channel
 	///
@@ -108,13 +125,48 @@ public:
 	///
 	void setCurrentTime(const int64_t& now);
 
+private:
+	///
+	/// Updates the entry of a priority channel, except for its led colors
+	///
+	/// @return The entry of the channel
+	///
+	InputInfo & updateInput(const int priority, const int64_t timeoutTime_ms);
+
+	///
+	/// Queues the timeout of a priority channel, unless an earlier timeout of the channel is
+	/// already queued
+	///
+	/// @param priority The priority of the channel
+	/// @param timeoutTime_ms The absolute timeout of the channel
+	///
+	void queueTimeout(const int priority, const int64_t timeoutTime_ms);
+
+	///
+	/// Updates the current priority after a priority channel has been removed
+	///
+	void updateCurrentPriority();
+
 private:
 	/// The current priority (lowest value in _activeInputs)
 	int _currentPriority;
 
-	/// The mapping from priority channel to led-information
+	/// The mapping from priority channel to led-information (ordered by priority)
 	QMap<int, InputInfo> _activeInputs;
 
+	/// A timeout of a priority channel
+	typedef std::pair<int64_t, int> Timeout;
+
+	/// Min-heap with the timeouts of the priority channels. Entries are not removed when a channel
+	/// is updated or cleared; an entry only clears its channel when the timeout still matches.
+	/// A later timeout is not queued while an earlier entry of the channel is queued; that entry
+	/// queues the actual timeout of the channel when it expires. This keeps the heap at about one
+	/// entry per channel, independent of the update rate.
+	std::priority_queue<Timeout, std::vector<Timeout>, std::greater<Timeout>> _timeouts;
+
+	/// The earliest queued timeout per priority channel
+	std::map<int, int64_t> _queuedTimeouts;
+
 	/// The information of the lowest priority channel
 	InputInfo _lowestPriorityInfo;
 
@@ -0,0 +1,127 @@
+#pragma once
+
+// STL includes
+#include <atomic>
+
+///
+/// Bounded, latest-wins hand-over of frames from a single producer thread to a single consumer
+/// thread. The ring holds three slots: one written by the producer, one read by the consumer and
+/// one holding the most recently published frame. Publishing a frame replaces an unread frame,
+/// so a slow consumer always gets the newest frame and never a backlog of stale ones. Neither
+/// side ever blocks or allocates.
+///
+template <typename Frame_T>
+class FrameRing
+{
+public:
+	///
+	/// Constructs a ring with all slots set to the given frame
+	///
+	/// @param[in] frame The initial value of the slots
+	///
+	FrameRing(const Frame_T & frame = Frame_T()) :
+		_producer(0),
+		_published(1),
+		_consumer(2),
+		_dropped(0)
+	{
+		for (Frame_T & slot : _slots)
+		{
+			slot = frame;
+		}
+	}
+
+	///
+	/// Returns the slot into which the producer writes its next frame
+	///
+	/// @return The slot of the producer
+	///
+	Frame_T & producerSlot()
+	{
+		return _slots[_producer];
+	}
+
+	///
+	/// Publishes the producer slot as the newest frame. An earlier frame which has not been taken
+	/// by the consumer is dropped.
+	///
+	/// @return True if an unread frame was dropped
+	///
+	bool publish()
+	{
+		const unsigned previous = _published.exchange(_producer | FRESH);
+		_producer = previous & INDEX;
+		if (previous & FRESH)
+		{
+			++_dropped;
+			return true;
+		}
+		return false;
+	}
+
+	///
+	/// Takes the newest frame for the consumer, if a frame was published since the last take
+	///
+	/// @return True if a new frame is available in the consumer slot
+	///
+	bool take()
+	{
+		if ((_published.load() & FRESH) == 0)
+		{
+			return false;
+		}
+
+		_consumer = _published.exchange(_consumer) & INDEX;
+		return true;
+	}
+
+	///
+	/// Returns the slot with the frame last taken by the consumer
+	///
+	/// @return The slot of the consumer
+	///
+	const Frame_T & consumerSlot() const
+	{
+		return _slots[_consumer];
+	}
+
+	///
+	/// Returns the slot with the frame last taken by the consumer. The consumer may modify the
+	/// frame, or swap it out, until its next take.
+	///
+	/// @return The slot of the consumer
+	///
+	Frame_T & consumerSlot()
+	{
+		return _slots[_consumer];
+	}
+
+	///
+	/// Returns the number of frames which were replaced before the consumer took them
+	///
+	/// @return The number of dropped frames
+	///
+	unsigned droppedFrames() const
+	{
+		return _dropped.load();
+	}
+
+private:
+	/// Mask of the slot index in the published state
+	static const unsigned INDEX = 0x3;
+	/// Flag in the published state indicating the frame has not been taken yet
+	static const unsigned FRESH = 0x4;
+
+	/// The slots of the ring
+	Frame_T _slots[3];
+
+	/// The slot owned by the producer
+	unsigned _producer;
+	/// The slot with the newest published frame (and the FRESH flag)
+	std::atomic<unsigned> _published;
+	/// The slot owned by the consumer
+	unsigned _consumer;
+
+	/// The number of dropped frames
+	std::atomic<unsigned> _dropped;
+};
@@ -2,10 +2,22 @@
 
 // STL includes
 #include <vector>
+#include <cassert>
 #include <cstdint>
 #include <cstring>
 #include <algorithm>
+#include <utility>
 
+// Utils includes
+#include <utils/ImageBuffer.h>
+
+///
+/// Image with implicitly shared pixels. Copying an image only shares its (pooled) buffer; the
+/// pixels are copied when a shared image is written to (through memptr() or operator()), so
+/// images can be passed by value, also through queued signals, without copying the frames.
+/// The non-const accessors copy a shared image even when they are only used to read; pixels
+/// which are only read are accessed through a const reference or constMemptr().
+///
 template <typename Pixel_T>
 class Image
 {
@@ -19,8 +31,8 @@ public:
 	Image() :
 		_width(1),
 		_height(1),
-		_pixels(new Pixel_T[2]),
-		_endOfPixels(_pixels + 1)
+		_buffer(ImageBuffer::acquire(2*sizeof(Pixel_T))),
+		_pixels(reinterpret_cast<Pixel_T *>(_buffer->data()))
 	{
 		memset(_pixels, 0, 2*sizeof(Pixel_T));
 	}
@@ -34,8 +46,8 @@ public:
 	Image(const unsigned width, const unsigned height) :
 		_width(width),
 		_height(height),
-		_pixels(new Pixel_T[width * height + 1]),
-		_endOfPixels(_pixels + width * height)
+		_buffer(ImageBuffer::acquire((width * height + 1) * sizeof(Pixel_T))),
+		_pixels(reinterpret_cast<Pixel_T *>(_buffer->data()))
 	{
 		memset(_pixels, 0, (_width*_height+1)*sizeof(Pixel_T));
 	}
@@ -50,22 +62,37 @@ public:
 	Image(const unsigned width, const unsigned height, const Pixel_T background) :
 		_width(width),
 		_height(height),
-		_pixels(new Pixel_T[width * height + 1]),
-		_endOfPixels(_pixels + width * height)
+		_buffer(ImageBuffer::acquire((width * height + 1) * sizeof(Pixel_T))),
+		_pixels(reinterpret_cast<Pixel_T *>(_buffer->data()))
 	{
-		std::fill(_pixels, _endOfPixels, background);
+		std::fill(_pixels, _pixels + width * height, background);
 	}
 
 	///
-	/// Copy constructor for an image
+	/// Copy constructor for an image; the pixels are shared until either image is written to
 	///
 	Image(const Image & other) :
 		_width(other._width),
 		_height(other._height),
-		_pixels(new Pixel_T[other._width * other._height + 1]),
-		_endOfPixels(_pixels + other._width * other._height)
+		_buffer(other._buffer != nullptr ? other._buffer->addRef() : nullptr),
+		_pixels(other._pixels)
+	{
+		// empty
+	}
+
+	///
+	/// Move constructor for an image; the other image is left empty (0x0)
+	///
+	Image(Image && other) :
+		_width(other._width),
+		_height(other._height),
+		_buffer(other._buffer),
+		_pixels(other._pixels)
 	{
-		memcpy(_pixels, other._pixels, other._width * other._height * sizeof(Pixel_T));
+		other._width = 0;
+		other._height = 0;
+		other._buffer = nullptr;
+		other._pixels = nullptr;
 	}
 
 	///
@@ -73,7 +100,41 @@ public:
 	///
 	~Image()
 	{
-		delete[] _pixels;
+		if (_buffer != nullptr)
+		{
+			_buffer->release();
+		}
+	}
+
+	///
+	/// Assigns another image to this image; the pixels are shared until either image is written to
+	///
+	Image & operator=(const Image & other)
+	{
+		Image copy(other);
+		swap(copy);
+		return *this;
+	}
+
+	///
+	/// Moves another image into this image; the other image is left empty (0x0)
+	///
+	Image & operator=(Image && other)
+	{
+		Image moved(std::move(other));
+		swap(moved);
+		return *this;
+	}
+
+	///
+	/// Exchanges the pixels of this image with another image
+	///
+	void swap(Image & other)
+	{
+		std::swap(_width, other._width);
+		std::swap(_height, other._height);
+		std::swap(_buffer, other._buffer);
+		std::swap(_pixels, other._pixels);
 	}
 
 	///
@@ -139,19 +200,20 @@ public:
 	///
 	Pixel_T& operator()(const unsigned x, const unsigned y)
 	{
+		detach();
 		return _pixels[toIndex(x,y)];
 	}
 
-	/// Resize the image
+	/// Resize the image (the content of the resized image is undefined)
 	/// @param width The width of the image
 	/// @param height The height of the image
 	void resize(const unsigned width, const unsigned height)
 	{
-		if ((width*height) > (_endOfPixels-_pixels))
+		const size_t size = (width * height + 1) * sizeof(Pixel_T);
+		if (_buffer == nullptr || _buffer->isShared() || size > _buffer->capacity())
 		{
-			delete[] _pixels;
-			_pixels = new Pixel_T[width*height + 1];
-			_endOfPixels = _pixels + width*height;
+			// the pixels are not kept, so they do not have to be copied
+			reset(ImageBuffer::acquire(size));
 		}
 
 		_width = width;
@@ -168,6 +230,16 @@ public:
 		assert(other._width == _width);
 		assert(other._height == _height);
 
+		if (_width == 0 || _height == 0)
+		{
+			// nothing to copy (a moved-from image has no buffer)
+			return;
+		}
+
+		if (_buffer == nullptr || _buffer->isShared())
+		{
+			reset(ImageBuffer::acquire((_width * _height + 1) * sizeof(Pixel_T)));
+		}
 		memcpy(_pixels, other._pixels, _width*_height*sizeof(Pixel_T));
 	}
 
@@ -177,6 +249,7 @@ public:
 	///
 	Pixel_T* memptr()
 	{
+		detach();
 		return _pixels;
 	}
 
@@ -188,7 +261,44 @@ public:
 	{
 		return _pixels;
 	}
+
+	///
+	/// Returns a const memory pointer to the first pixel in the image, without copying the pixels
+	/// of a shared image (also when called on a non-const image)
+	/// @return The const memory pointer to the first pixel
+	///
+	const Pixel_T* constMemptr() const
+	{
+		return _pixels;
+	}
 private:
+	///
+	/// Gives the image its own copy of the pixels if the buffer is shared with other images
+	///
+	inline void detach()
+	{
+		if (_buffer != nullptr && _buffer->isShared())
+		{
+			ImageBuffer * buffer = ImageBuffer::acquire((_width * _height + 1) * sizeof(Pixel_T));
+			memcpy(buffer->data(), _pixels, _width * _height * sizeof(Pixel_T));
+			reset(buffer);
+		}
+	}
+
+	///
+	/// Replaces the buffer of the image (releasing the current buffer)
+	///
+	/// @param buffer The new buffer
+	///
+	void reset(ImageBuffer * buffer)
+	{
+		if (_buffer != nullptr)
+		{
+			_buffer->release();
+		}
+		_buffer = buffer;
+		_pixels = reinterpret_cast<Pixel_T *>(_buffer->data());
+	}
 
 	///
 	/// Translate x and y coordinate to index of the underlying vector
@@ -209,9 +319,9 @@ private:
 	/// The height of the image
 	unsigned _height;
 
-	/// The pixels of the image
-	Pixel_T* _pixels;
+	/// The (shared) buffer holding the pixels
+	ImageBuffer* _buffer;
 
-	/// Pointer to the last(extra) pixel
-	Pixel_T* _endOfPixels;
+	/// The pixels of the image (the data of the buffer)
+	Pixel_T* _pixels;
 };
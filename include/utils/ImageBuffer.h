@@ -0,0 +1,93 @@
+#pragma once
+
+// STL includes
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+///
+/// Reference counted storage of the pixels of an Image. The buffers are allocated from a
+/// process-wide pool with free lists per size class (four classes per power of two), so releasing
+/// a buffer and acquiring one of a similar size (as a grabber does for every frame) does not touch
+/// the heap. Buffers can be shared by multiple images (on multiple threads); an image copies its
+/// buffer before writing to a shared buffer.
+///
+class ImageBuffer
+{
+public:
+	///
+	/// Acquires a buffer from the pool with (at least) the given capacity. The content of the buffer
+	/// is undefined and the reference count is one.
+	///
+	/// @param size The required capacity [bytes]
+	///
+	/// @return The buffer
+	///
+	static ImageBuffer * acquire(size_t size);
+
+	///
+	/// Adds a reference to the buffer
+	///
+	/// @return The buffer
+	///
+	inline ImageBuffer * addRef()
+	{
+		_refs.fetch_add(1, std::memory_order_relaxed);
+		return this;
+	}
+
+	///
+	/// Removes a reference from the buffer. The buffer is returned to the pool when the last
+	/// reference is removed.
+	///
+	void release();
+
+	///
+	/// Returns if the buffer is referenced by more than one image
+	///
+	/// @return True if the buffer is shared
+	///
+	inline bool isShared() const
+	{
+		return _refs.load(std::memory_order_acquire) != 1;
+	}
+
+	///
+	/// Returns the capacity of the buffer
+	///
+	/// @return The capacity [bytes]
+	///
+	inline size_t capacity() const
+	{
+		return _capacity;
+	}
+
+	///
+	/// Returns the first byte of the buffer
+	///
+	/// @return The memory pointer to the first byte
+	///
+	inline uint8_t * data()
+	{
+		return reinterpret_cast<uint8_t *>(this) + headerSize();
+	}
+
+private:
+	/// Returns the size of the header in front of the data (rounded to keep the data aligned)
+	static inline size_t headerSize()
+	{
+		return (sizeof(ImageBuffer) + 15) / 16 * 16;
+	}
+
+	/// Constructor for the header of a buffer allocated by the pool
+	ImageBuffer(size_t capacity, size_t sizeClass);
+
+	/// The number of images referencing the buffer
+	std::atomic<int> _refs;
+
+	/// The capacity of the buffer [bytes]
+	const size_t _capacity;
+
+	/// The size class of the buffer in the pool
+	const size_t _sizeClass;
+};
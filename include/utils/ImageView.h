@@ -0,0 +1,149 @@
+#pragma once
+
+// STL includes
+#include <cstdint>
+
+// Utils includes
+#include <utils/Image.h>
+
+///
+/// Non-owning view on an image which is stored elsewhere in memory (an Image, a network payload, a
+/// capture buffer, ...). The rows of the view are 'stride' bytes apart, so a view can also refer to
+/// a part of a larger image (for example a cropped picture or one half of a 3D frame). The memory
+/// must remain valid for as long as the view is used.
+///
+/// Frames which are captured in another pixel format are not viewed: the v4l2 grabber reads yuv
+/// frames (and the half of a 3D frame) in place through YuvImage, and only converts the sampled
+/// pixels of rgb32 frames into an Image. The dispmanx grabber reads the (half) frame directly into
+/// the image it reuses.
+///
+template <typename Pixel_T>
+class ImageView
+{
+public:
+	typedef Pixel_T pixel_type;
+
+	///
+	/// Constructs a view on the given pixels
+	///
+	/// @param pixels The first pixel of the view
+	/// @param width The width of the view
+	/// @param height The height of the view
+	/// @param stride The number of bytes between the first pixels of two consecutive rows
+	///
+	ImageView(const Pixel_T * pixels, const unsigned width, const unsigned height, const unsigned stride) :
+		_pixels(reinterpret_cast<const uint8_t *>(pixels)),
+		_width(width),
+		_height(height),
+		_stride(stride)
+	{
+		// empty
+	}
+
+	///
+	/// Constructs a view on the given pixels, with the rows following each other without padding
+	///
+	/// @param pixels The first pixel of the view
+	/// @param width The width of the view
+	/// @param height The height of the view
+	///
+	ImageView(const Pixel_T * pixels, const unsigned width, const unsigned height) :
+		ImageView(pixels, width, height, width * sizeof(Pixel_T))
+	{
+		// empty
+	}
+
+	///
+	/// Constructs a view on the complete image
+	///
+	/// @param image The image to view
+	///
+	ImageView(const Image<Pixel_T> & image) :
+		ImageView(image.memptr(), image.width(), image.height())
+	{
+		// empty
+	}
+
+	///
+	/// Returns the width of the view
+	///
+	/// @return The width of the view
+	///
+	inline unsigned width() const
+	{
+		return _width;
+	}
+
+	///
+	/// Returns the height of the view
+	///
+	/// @return The height of the view
+	///
+	inline unsigned height() const
+	{
+		return _height;
+	}
+
+	///
+	/// Returns the number of bytes between the first pixels of two consecutive rows
+	///
+	/// @return The stride of the view
+	///
+	inline unsigned stride() const
+	{
+		return _stride;
+	}
+
+	///
+	/// Returns the first pixel of the given row
+	///
+	/// @param y The row
+	///
+	/// @return The const pointer to the first pixel of the row
+	///
+	inline const Pixel_T * row(const unsigned y) const
+	{
+		return reinterpret_cast<const Pixel_T *>(_pixels + y * _stride);
+	}
+
+	///
+	/// Returns a const reference to a specified pixel in the view
+	///
+	/// @param x The x index
+	/// @param y The y index
+	///
+	/// @return const reference to specified pixel
+	///
+	inline const Pixel_T & operator()(const unsigned x, const unsigned y) const
+	{
+		return row(y)[x];
+	}
+
+	///
+	/// Returns a view on a rectangular part of this view
+	///
+	/// @param x The first column of the part
+	/// @param y The first row of the part
+	/// @param width The width of the part
+	/// @param height The height of the part
+	///
+	/// @return The view on the part
+	///
+	ImageView<Pixel_T> subView(const unsigned x, const unsigned y, const unsigned width, const unsigned height) const
+	{
+		return ImageView<Pixel_T>(row(y) + x, width, height, _stride);
+	}
+
+private:
+	/// The first byte of the view
+	const uint8_t * _pixels;
+
+	/// The width of the view
+	unsigned _width;
+
+	/// The height of the view
+	unsigned _height;
+
+	/// The number of bytes between two rows
+	unsigned _stride;
+};
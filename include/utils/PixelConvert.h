@@ -0,0 +1,62 @@
+#pragma once
+
+// STL includes
+#include <cstdint>
+
+// Utils includes
+#include <utils/ColorRgb.h>
+#include <utils/Image.h>
+
+///
+/// Enumeration of the byte layouts of captured frames which can be converted to rgb
+///
+enum PixelLayout
+{
+	/// Packed yuv 4:2:2, Y0 U Y1 V
+	PIXELLAYOUT_YUYV,
+	/// Packed yuv 4:2:2, U Y0 V Y1
+	PIXELLAYOUT_UYVY,
+	/// 32-bit rgb, R G B X
+	PIXELLAYOUT_RGB32
+};
+
+///
+/// Converts pixels of a single row of a frame to rgb. The conversion of yuv uses precomputed
+/// coefficient tables (video range, BT.601) and, for consecutive pixels, NEON or SSE2 kernels
+/// when available. The layout is a template argument so the conversion loop does not branch on it.
+///
+/// @param[in] row The first byte of the row of the frame
+/// @param[in] column The column of the first pixel to convert
+/// @param[in] step The number of columns between two converted pixels
+/// @param[in] count The number of pixels to convert
+/// @param[out] destination The converted pixels
+///
+template <PixelLayout Layout_T>
+void convertRow(const uint8_t * row, unsigned column, unsigned step, unsigned count, ColorRgb * destination);
+
+template <> void convertRow<PIXELLAYOUT_YUYV>(const uint8_t * row, unsigned column, unsigned step, unsigned count, ColorRgb * destination);
+template <> void convertRow<PIXELLAYOUT_UYVY>(const uint8_t * row, unsigned column, unsigned step, unsigned count, ColorRgb * destination);
+template <> void convertRow<PIXELLAYOUT_RGB32>(const uint8_t * row, unsigned column, unsigned step, unsigned count, ColorRgb * destination);
+
+///
+/// Converts a grid of pixels of a frame to an image: pixel (x, y) of the image is pixel
+/// (xOffset + x*xStep, yOffset + y*yStep) of the frame.
+///
+/// @param[in] data The first byte of the frame
+/// @param[in] stride The number of bytes of a single row of the frame
+/// @param[in] xOffset The column of the frame of the first column of the image
+/// @param[in] yOffset The row of the frame of the first row of the image
+/// @param[in] xStep The number of frame columns between two columns of the image
+/// @param[in] yStep The number of frame rows between two rows of the image
+/// @param[out] image The image to write the converted pixels to (determines the size of the grid)
+///
+template <PixelLayout Layout_T>
+void convertFrame(const uint8_t * data, unsigned stride, unsigned xOffset, unsigned yOffset, unsigned xStep, unsigned yStep, Image<ColorRgb> & image)
+{
+	// a shared image is copied only once (not for every row)
+	ColorRgb * pixels = image.memptr();
+	for (unsigned y = 0; y < image.height(); ++y)
+	{
+		convertRow<Layout_T>(data + (yOffset + y * yStep) * stride, xOffset, xStep, image.width(), pixels + y * image.width());
+	}
+}
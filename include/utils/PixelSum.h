@@ -0,0 +1,228 @@
+#pragma once
+
+// STL includes
+#include <cstdint>
+
+// SIMD includes
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define PIXELSUM_NEON
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define PIXELSUM_SSE2
+#endif
+
+// Utils includes
+#include <utils/ColorRgb.h>
+#include <utils/ColorRgba.h>
+
+///
+/// Accumulated sums of the red, green and blue channel of a range of pixels. The 32-bit sums can
+/// hold the channel total of more than 16 million pixels.
+///
+struct ChannelSums
+{
+	/// The sum of the red channel
+	uint32_t red;
+	/// The sum of the green channel
+	uint32_t green;
+	/// The sum of the blue channel
+	uint32_t blue;
+};
+
+///
+/// Adds the channels of the given pixels to the sums, one pixel at a time. This works for any pixel
+/// type with red, green and blue members.
+///
+/// @param[in] pixels The first pixel to add
+/// @param[in] count The number of pixels to add
+/// @param[in,out] sums The sums to add the pixels to
+///
+template <typename Pixel_T>
+inline void sumPixelsScalar(const Pixel_T * pixels, unsigned count, ChannelSums & sums)
+{
+	uint32_t red   = 0;
+	uint32_t green = 0;
+	uint32_t blue  = 0;
+	for (const Pixel_T * end = pixels + count; pixels != end; ++pixels)
+	{
+		red   += pixels->red;
+		green += pixels->green;
+		blue  += pixels->blue;
+	}
+	sums.red   += red;
+	sums.green += green;
+	sums.blue  += blue;
+}
+
+///
+/// Adds the channels of every step-th pixel to the sums
+///
+/// @param[in] pixels The first pixel to add
+/// @param[in] count The number of pixels to add
+/// @param[in] step The distance between two added pixels
+/// @param[in,out] sums The sums to add the pixels to
+///
+template <typename Pixel_T>
+inline void sumPixelsStrided(const Pixel_T * pixels, unsigned count, unsigned step, ChannelSums & sums)
+{
+	uint32_t red   = 0;
+	uint32_t green = 0;
+	uint32_t blue  = 0;
+	for (unsigned i = 0; i < count; ++i, pixels += step)
+	{
+		red   += pixels->red;
+		green += pixels->green;
+		blue  += pixels->blue;
+	}
+	sums.red   += red;
+	sums.green += green;
+	sums.blue  += blue;
+}
+
+///
+/// Adds the channels of the given pixels to the sums. Pixel types without a dedicated (vectorised)
+/// kernel use the scalar implementation.
+///
+/// @param[in] pixels The first pixel to add
+/// @param[in] count The number of pixels to add
+/// @param[in,out] sums The sums to add the pixels to
+///
+template <typename Pixel_T>
+inline void sumPixels(const Pixel_T * pixels, unsigned count, ChannelSums & sums)
+{
+	sumPixelsScalar(pixels, count, sums);
+}
+
+///
+/// Adds the channels of the given packed 24-bit pixels to the sums, 16 pixels per iteration when
+/// NEON or SSE2 is available.
+///
+/// @param[in] pixels The first pixel to add
+/// @param[in] count The number of pixels to add
+/// @param[in,out] sums The sums to add the pixels to
+///
+inline void sumPixels(const ColorRgb * pixels, unsigned count, ChannelSums & sums)
+{
+	const unsigned blockCount = count / 16;
+	const uint8_t * data = reinterpret_cast<const uint8_t *>(pixels);
+
+#if defined(PIXELSUM_NEON)
+	uint32x4_t red   = vdupq_n_u32(0);
+	uint32x4_t green = vdupq_n_u32(0);
+	uint32x4_t blue  = vdupq_n_u32(0);
+	for (unsigned i = 0; i < blockCount; ++i, data += 48)
+	{
+		// deinterleave 16 pixels and widen-accumulate each channel
+		const uint8x16x3_t rgb = vld3q_u8(data);
+		red   = vpadalq_u16(red,   vpaddlq_u8(rgb.val[0]));
+		green = vpadalq_u16(green, vpaddlq_u8(rgb.val[1]));
+		blue  = vpadalq_u16(blue,  vpaddlq_u8(rgb.val[2]));
+	}
+	sums.red   += vgetq_lane_u32(red,   0) + vgetq_lane_u32(red,   1) + vgetq_lane_u32(red,   2) + vgetq_lane_u32(red,   3);
+	sums.green += vgetq_lane_u32(green, 0) + vgetq_lane_u32(green, 1) + vgetq_lane_u32(green, 2) + vgetq_lane_u32(green, 3);
+	sums.blue  += vgetq_lane_u32(blue,  0) + vgetq_lane_u32(blue,  1) + vgetq_lane_u32(blue,  2) + vgetq_lane_u32(blue,  3);
+	pixels += blockCount * 16;
+	count  -= blockCount * 16;
+#elif defined(PIXELSUM_SSE2)
+	// In a block of 48 bytes, byte m of the k-th 16-byte load belongs to channel (m+k)%3. The masks
+	// select the bytes with m%3 == 0, 1 and 2.
+	const __m128i mask0 = _mm_setr_epi8(-1,0,0,-1,0,0,-1,0,0,-1,0,0,-1,0,0,-1);
+	const __m128i mask1 = _mm_setr_epi8(0,-1,0,0,-1,0,0,-1,0,0,-1,0,0,-1,0,0);
+	const __m128i mask2 = _mm_setr_epi8(0,0,-1,0,0,-1,0,0,-1,0,0,-1,0,0,-1,0);
+	const __m128i zero  = _mm_setzero_si128();
+
+	__m128i red   = zero;
+	__m128i green = zero;
+	__m128i blue  = zero;
+	for (unsigned i = 0; i < blockCount; ++i, data += 48)
+	{
+		const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+		const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 16));
+		const __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 32));
+
+		// the sum of absolute differences against zero adds the selected bytes into 64-bit lanes
+		red   = _mm_add_epi64(red,   _mm_sad_epu8(_mm_and_si128(v0, mask0), zero));
+		red   = _mm_add_epi64(red,   _mm_sad_epu8(_mm_and_si128(v1, mask2), zero));
+		red   = _mm_add_epi64(red,   _mm_sad_epu8(_mm_and_si128(v2, mask1), zero));
+		green = _mm_add_epi64(green, _mm_sad_epu8(_mm_and_si128(v0, mask1), zero));
+		green = _mm_add_epi64(green, _mm_sad_epu8(_mm_and_si128(v1, mask0), zero));
+		green = _mm_add_epi64(green, _mm_sad_epu8(_mm_and_si128(v2, mask2), zero));
+		blue  = _mm_add_epi64(blue,  _mm_sad_epu8(_mm_and_si128(v0, mask2), zero));
+		blue  = _mm_add_epi64(blue,  _mm_sad_epu8(_mm_and_si128(v1, mask1), zero));
+		blue  = _mm_add_epi64(blue,  _mm_sad_epu8(_mm_and_si128(v2, mask0), zero));
+	}
+	sums.red   += uint32_t(_mm_cvtsi128_si32(red))   + uint32_t(_mm_cvtsi128_si32(_mm_srli_si128(red,   8)));
+	sums.green += uint32_t(_mm_cvtsi128_si32(green)) + uint32_t(_mm_cvtsi128_si32(_mm_srli_si128(green, 8)));
+	sums.blue  += uint32_t(_mm_cvtsi128_si32(blue))  + uint32_t(_mm_cvtsi128_si32(_mm_srli_si128(blue,  8)));
+	pixels += blockCount * 16;
+	count  -= blockCount * 16;
+#else
+	(void) blockCount;
+	(void) data;
+#endif
+
+	// the remaining pixels
+	sumPixelsScalar(pixels, count, sums);
+}
+
+///
+/// Adds the channels of the given 32-bit pixels to the sums, 16 pixels per iteration when NEON or
+/// SSE2 is available. The alpha channel is ignored.
+///
+/// @param[in] pixels The first pixel to add
+/// @param[in] count The number of pixels to add
+/// @param[in,out] sums The sums to add the pixels to
+///
+inline void sumPixels(const ColorRgba * pixels, unsigned count, ChannelSums & sums)
+{
+	const unsigned blockCount = count / 16;
+	const uint8_t * data = reinterpret_cast<const uint8_t *>(pixels);
+
+#if defined(PIXELSUM_NEON)
+	uint32x4_t red   = vdupq_n_u32(0);
+	uint32x4_t green = vdupq_n_u32(0);
+	uint32x4_t blue  = vdupq_n_u32(0);
+	for (unsigned i = 0; i < blockCount; ++i, data += 64)
+	{
+		// deinterleave 16 pixels and widen-accumulate each channel
+		const uint8x16x4_t rgba = vld4q_u8(data);
+		red   = vpadalq_u16(red,   vpaddlq_u8(rgba.val[0]));
+		green = vpadalq_u16(green, vpaddlq_u8(rgba.val[1]));
+		blue  = vpadalq_u16(blue,  vpaddlq_u8(rgba.val[2]));
+	}
+	sums.red   += vgetq_lane_u32(red,   0) + vgetq_lane_u32(red,   1) + vgetq_lane_u32(red,   2) + vgetq_lane_u32(red,   3);
+	sums.green += vgetq_lane_u32(green, 0) + vgetq_lane_u32(green, 1) + vgetq_lane_u32(green, 2) + vgetq_lane_u32(green, 3);
+	sums.blue  += vgetq_lane_u32(blue,  0) + vgetq_lane_u32(blue,  1) + vgetq_lane_u32(blue,  2) + vgetq_lane_u32(blue,  3);
+	pixels += blockCount * 16;
+	count  -= blockCount * 16;
+#elif defined(PIXELSUM_SSE2)
+	const __m128i maskRed   = _mm_set1_epi32(0x000000FF);
+	const __m128i maskGreen = _mm_set1_epi32(0x0000FF00);
+	const __m128i maskBlue  = _mm_set1_epi32(0x00FF0000);
+	const __m128i zero      = _mm_setzero_si128();
+
+	__m128i red   = zero;
+	__m128i green = zero;
+	__m128i blue  = zero;
+	for (unsigned i = 0; i < blockCount * 4; ++i, data += 16)
+	{
+		// the sum of absolute differences against zero adds the selected bytes into 64-bit lanes
+		const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+		red   = _mm_add_epi64(red,   _mm_sad_epu8(_mm_and_si128(v, maskRed),   zero));
+		green = _mm_add_epi64(green, _mm_sad_epu8(_mm_and_si128(v, maskGreen), zero));
+		blue  = _mm_add_epi64(blue,  _mm_sad_epu8(_mm_and_si128(v, maskBlue),  zero));
+	}
+	sums.red   += uint32_t(_mm_cvtsi128_si32(red))   + uint32_t(_mm_cvtsi128_si32(_mm_srli_si128(red,   8)));
+	sums.green += uint32_t(_mm_cvtsi128_si32(green)) + uint32_t(_mm_cvtsi128_si32(_mm_srli_si128(green, 8)));
+	sums.blue  += uint32_t(_mm_cvtsi128_si32(blue))  + uint32_t(_mm_cvtsi128_si32(_mm_srli_si128(blue,  8)));
+	pixels += blockCount * 16;
+	count  -= blockCount * 16;
+#else
+	(void) blockCount;
+	(void) data;
+#endif
+
+	// the remaining pixels
+	sumPixelsScalar(pixels, count, sums);
+}
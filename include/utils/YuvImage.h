@@ -0,0 +1,198 @@
+#pragma once
+
+// STL includes
+#include <cstdint>
+
+// Utils includes
+#include <utils/ColorRgb.h>
+
+///
+/// Non-owning view on a captured packed YUV 4:2:2 frame (YUYV or UYVY). The view selects a grid of
+/// pixels from the frame: pixel (x, y) of the view is pixel (xOffset + x*xStep, yOffset + y*yStep)
+/// of the frame. This makes it possible to apply the cropping and decimation of a grabber without
+/// converting (or copying) the frame. Pixels are only converted to rgb when they are accessed.
+///
+class YuvImage
+{
+public:
+	typedef ColorRgb pixel_type;
+
+	///
+	/// Constructs a view on the given frame
+	///
+	/// @param data The first byte of the frame
+	/// @param stride The number of bytes of a single row of the frame
+	/// @param uyvy True when the frame is UYVY, false when the frame is YUYV
+	/// @param width The width of the view
+	/// @param height The height of the view
+	/// @param xOffset The column of the frame of the first column of the view
+	/// @param yOffset The row of the frame of the first row of the view
+	/// @param xStep The number of frame columns between two columns of the view
+	/// @param yStep The number of frame rows between two rows of the view
+	///
+	YuvImage(const uint8_t * data, unsigned stride, bool uyvy, unsigned width, unsigned height, unsigned xOffset, unsigned yOffset, unsigned xStep, unsigned yStep) :
+		_data(data),
+		_stride(stride),
+		_uyvy(uyvy),
+		_width(width),
+		_height(height),
+		_xOffset(xOffset),
+		_yOffset(yOffset),
+		_xStep(xStep),
+		_yStep(yStep)
+	{
+		// empty
+	}
+
+	///
+	/// Returns the width of the view
+	///
+	/// @return The width of the view
+	///
+	inline unsigned width() const
+	{
+		return _width;
+	}
+
+	///
+	/// Returns the height of the view
+	///
+	/// @return The height of the view
+	///
+	inline unsigned height() const
+	{
+		return _height;
+	}
+
+	///
+	/// Returns true when the frame is UYVY, false when the frame is YUYV
+	///
+	inline bool isUyvy() const
+	{
+		return _uyvy;
+	}
+
+	///
+	/// Returns the first byte of the frame row of the given row of the view
+	///
+	/// @param y The row of the view
+	///
+	/// @return The first byte of the frame row
+	///
+	inline const uint8_t * row(unsigned y) const
+	{
+		return _data + (_yOffset + y * _yStep) * _stride;
+	}
+
+	///
+	/// Returns the frame column of the given column of the view
+	///
+	/// @param x The column of the view
+	///
+	/// @return The column of the frame
+	///
+	inline unsigned column(unsigned x) const
+	{
+		return _xOffset + x * _xStep;
+	}
+
+	///
+	/// Returns the number of frame columns between two columns of the view
+	///
+	inline unsigned columnStep() const
+	{
+		return _xStep;
+	}
+
+	///
+	/// Reads the luma and (shared) chroma of a pixel of the view
+	///
+	/// @param x The column of the view
+	/// @param y The row of the view
+	/// @param[out] luma The luma (Y) of the pixel
+	/// @param[out] u The blue difference chroma (U) of the pixel
+	/// @param[out] v The red difference chroma (V) of the pixel
+	///
+	inline void yuv(unsigned x, unsigned y, uint8_t & luma, uint8_t & u, uint8_t & v) const
+	{
+		const unsigned frameColumn = column(x);
+		const uint8_t * pair = row(y) + (frameColumn & ~1u) * 2;
+		if (_uyvy)
+		{
+			luma = pair[(frameColumn & 1) * 2 + 1];
+			u = pair[0];
+			v = pair[2];
+		}
+		else
+		{
+			luma = pair[(frameColumn & 1) * 2];
+			u = pair[1];
+			v = pair[3];
+		}
+	}
+
+	///
+	/// Converts a pixel of the view to rgb
+	///
+	/// @param x The column of the view
+	/// @param y The row of the view
+	///
+	/// @return The rgb color of the pixel
+	///
+	inline ColorRgb operator()(unsigned x, unsigned y) const
+	{
+		uint8_t luma, u, v;
+		yuv(x, y, luma, u, v);
+		return toRgb(luma, u, v);
+	}
+
+	///
+	/// Converts a (video range, BT.601) yuv color to rgb
+	///
+	/// @see http://en.wikipedia.org/wiki/YUV#Y.27UV444_to_RGB888_conversion
+	///
+	/// @param luma The luma (Y)
+	/// @param u The blue difference chroma (U)
+	/// @param v The red difference chroma (V)
+	///
+	/// @return The rgb color
+	///
+	static inline ColorRgb toRgb(int luma, int u, int v)
+	{
+		const int c = luma - 16;
+		const int d = u - 128;
+		const int e = v - 128;
+
+		return ColorRgb{
+			clamp((298 * c + 409 * e + 128) >> 8),
+			clamp((298 * c - 100 * d - 208 * e + 128) >> 8),
+			clamp((298 * c + 516 * d + 128) >> 8)};
+	}
+
+private:
+	static inline uint8_t clamp(int x)
+	{
+		return (x<0) ? 0 : ((x>255) ? 255 : uint8_t(x));
+	}
+
+private:
+	/// The first byte of the frame
+	const uint8_t * _data;
+	/// The number of bytes of a single row of the frame
+	const unsigned _stride;
+	/// Flag indicating UYVY (true) or YUYV (false) byte order
+	const bool _uyvy;
+
+	/// The width of the view
+	const unsigned _width;
+	/// The height of the view
+	const unsigned _height;
+	/// The frame column of the first column of the view
+	const unsigned _xOffset;
+	/// The frame row of the first row of the view
+	const unsigned _yOffset;
+	/// The number of frame columns between two view columns
+	const unsigned _xStep;
+	/// The number of frame rows between two view rows
+	const unsigned _yStep;
+};
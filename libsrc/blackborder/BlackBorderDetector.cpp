@@ -1,4 +1,7 @@
 
+// STL includes
+#include <algorithm>
+
 // BlackBorders includes
 #include <blackborder/BlackBorderDetector.h>
 
@@ -9,3 +12,18 @@ BlackBorderDetector::BlackBorderDetector(uint8_t blackborderThreshold) :
 {
 	// empty
 }
+
+bool BlackBorderDetector::isBlackRow(const ImageView<ColorRgb> & image, int y)
+{
+	// a pixel is black when all its channels are below the threshold, so the row is black when
+	// the maximum of all its bytes is below the threshold
+	const uint8_t * row = reinterpret_cast<const uint8_t *>(image.row(y));
+	const unsigned byteCount = image.width() * sizeof(ColorRgb);
+
+	uint8_t maximum = 0;
+	for (unsigned i = 0; i < byteCount; ++i)
+	{
+		maximum = std::max(maximum, row[i]);
+	}
+	return maximum < _blackborderThreshold;
+}
@@ -1,4 +1,7 @@
 
+// STL includes
+#include <algorithm>
+
 // Blackborder includes
 #include <blackborder/BlackBorderProcessor.h>
 
@@ -7,10 +10,13 @@ using namespace hyperion;
 BlackBorderProcessor::BlackBorderProcessor(const unsigned unknownFrameCnt,
 		const unsigned borderFrameCnt,
 		const unsigned blurRemoveCnt,
-		uint8_t blackborderThreshold) :
-	_unknownSwitchCnt(unknownFrameCnt),
-	_borderSwitchCnt(borderFrameCnt),
+		uint8_t blackborderThreshold,
+		const unsigned detectionInterval) :
+	_unknownSwitchCnt(unknownFrameCnt / std::max(1u, detectionInterval)),
+	_borderSwitchCnt(borderFrameCnt / std::max(1u, detectionInterval)),
 	_blurRemoveCnt(blurRemoveCnt),
+	_detectionInterval(std::max(1u, detectionInterval)),
+	_frameCnt(0),
 	_detector(blackborderThreshold),
 	_currentBorder({true, -1, -1}),
 	_previousDetectedBorder({true, -1, -1}),
@@ -24,6 +30,24 @@ BlackBorder BlackBorderProcessor::getCurrentBorder() const
 	return _currentBorder;
 }
 
+namespace
+{
+	void shift(BlackBorder & border, int horizontalShift, int verticalShift)
+	{
+		if (!border.unknown)
+		{
+			border.horizontalSize = std::max(0, border.horizontalSize - horizontalShift);
+			border.verticalSize = std::max(0, border.verticalSize - verticalShift);
+		}
+	}
+}
+
+void BlackBorderProcessor::shiftBorder(int horizontalShift, int verticalShift)
+{
+	shift(_currentBorder, horizontalShift, verticalShift);
+	shift(_previousDetectedBorder, horizontalShift, verticalShift);
+}
+
 bool BlackBorderProcessor::updateBorder(const BlackBorder & newDetectedBorder)
 {
 	// set the consistency counter
@@ -303,9 +303,9 @@ PyObject* Effect::wrapSetImage(PyObject *self, PyObject *args)
 			int length = PyByteArray_Size(bytearray);
 			if (length == 3 * width * height)
 			{
-				Image<ColorRgb> image(width, height);
-				char * data = PyByteArray_AS_STRING(bytearray);
-				memcpy(image.memptr(), data, length);
+				// process the bytearray where it is
+				const char * data = PyByteArray_AS_STRING(bytearray);
+				const ImageView<ColorRgb> image(reinterpret_cast<const ColorRgb *>(data), width, height);
 
 				effect->_imageProcessor->process(image, effect->_colors);
 				effect->setColors(effect->_priority, effect->_colors, timeout, false);
@@ -10,7 +10,6 @@ AudioGrabberWrapper::AudioGrabberWrapper(const std::string & device,
 				int db_threshold,
 		Hyperion *hyperion,
 		int hyperionPriority) :
-	_timeout_ms(1000),
 	_priority(hyperionPriority),
 	_grabber(device,
 			freq,
@@ -19,13 +18,12 @@ AudioGrabberWrapper::AudioGrabberWrapper(const std::string & device,
 			num_bands,
 			db_threshold),
 	_hyperion(hyperion),
-	_ledColors(hyperion->getLedCount(), ColorRgb{0,0,0}),
-	_timer()
+	_timer(),
+	_channel(hyperion, hyperionPriority, 1000)
 {
 
 	// register the image type
 	qRegisterMetaType<Image<ColorRgb>>("Image<ColorRgb>");
-	qRegisterMetaType<std::vector<ColorRgb>>("std::vector<ColorRgb>");
 
 	// Handle the image in the captured thread using a direct connection
 	QObject::connect(
@@ -33,12 +31,6 @@ AudioGrabberWrapper::AudioGrabberWrapper(const std::string & device,
 				this, SLOT(newFrame(Image<ColorRgb>)),
 				Qt::DirectConnection);
 
-	// send color data to Hyperion using a queued connection to handle the data over to the main event loop
-	QObject::connect(
-				this, SIGNAL(emitColors(int,std::vector<ColorRgb>,int)),
-				_hyperion, SLOT(setColors(int,std::vector<ColorRgb>,int)),
-				Qt::QueuedConnection);
-
 	// setup the higher prio source checker
 	// this will disable the audio grabber when a source with higher priority is active
 	_timer.setInterval(500);
@@ -65,10 +57,10 @@ void AudioGrabberWrapper::stop()
 void AudioGrabberWrapper::newFrame(const Image<ColorRgb> &image)
 {
 	// process the new image
-	//_processor->process(image, _ledColors);
+	//_processor->process(image, _channel.producerSlot());
 
 	// send colors to Hyperion
-	emit emitColors(_priority, _ledColors, _timeout_ms);
+	_channel.publish();
 }
 
 void AudioGrabberWrapper::checkSources()
@@ -12,28 +12,36 @@
 #include <sys/time.h>
 #include <sys/mman.h>
 #include <sys/ioctl.h>
+#include <poll.h>
 #include <linux/videodev2.h>
 
+#include <QThread>
+
 #include "grabber/V4L2Grabber.h"
 
+#include <utils/PixelConvert.h>
+
 #define CLEAR(x) memset(&(x), 0, sizeof(x))
 
-static inline uint8_t clamp(int x)
+/// Thread which runs the capture loop of the grabber
+class V4L2Grabber::CaptureThread : public QThread
 {
-	return (x<0) ? 0 : ((x>255) ? 255 : uint8_t(x));
-}
+public:
+	CaptureThread(V4L2Grabber * grabber) :
+		QThread(),
+		_grabber(grabber)
+	{
+	}
 
-static void yuv2rgb(uint8_t y, uint8_t u, uint8_t v, uint8_t & r, uint8_t & g, uint8_t & b)
-{
-	// see: http://en.wikipedia.org/wiki/YUV#Y.27UV444_to_RGB888_conversion
-	int c = y - 16;
-	int d = u - 128;
-	int e = v - 128;
+protected:
+	virtual void run()
+	{
+		_grabber->capture_loop();
+	}
 
-	r = clamp((298 * c + 409 * e + 128) >> 8);
-	g = clamp((298 * c - 100 * d - 208 * e + 128) >> 8);
-	b = clamp((298 * c + 516 * d + 128) >> 8);
-}
+private:
+	V4L2Grabber * _grabber;
+};
 
 
 V4L2Grabber::V4L2Grabber(const std::string & device,
@@ -53,6 +61,7 @@ V4L2Grabber::V4L2Grabber(const std::string & device,
 	_width(width),
 	_height(height),
 	_frameByteSize(-1),
+	_bytesPerLine(-1),
 	_cropLeft(0),
 	_cropRight(0),
 	_cropTop(0),
@@ -61,11 +70,28 @@ V4L2Grabber::V4L2Grabber(const std::string & device,
 	_horizontalPixelDecimation(std::max(1, horizontalPixelDecimation)),
 	_verticalPixelDecimation(std::max(1, verticalPixelDecimation)),
 	_noSignalCounterThreshold(50),
+	_fullWidth(width),
+	_fullHeight(height),
+	_defaultIntervalNumerator(0),
+	_defaultIntervalDenominator(0),
+	_negotiate(true),
+	_softwareCropLeft(0),
+	_softwareCropRight(0),
+	_softwareCropTop(0),
+	_softwareCropBottom(0),
+	_softwareHorizontalDecimation(_horizontalPixelDecimation),
+	_softwareVerticalDecimation(_verticalPixelDecimation),
+	_softwareFrameDecimation(_frameDecimation),
+	_borderCropRows(0),
+	_borderCropColumns(0),
 	_noSignalThresholdColor(ColorRgb{0,0,0}),
 	_mode3D(VIDEO_2D),
 	_currentFrame(0),
 	_noSignalCounter(0),
-	_streamNotifier(nullptr)
+	_streamNotifier(nullptr),
+	_captureThread(nullptr),
+	_capturing(false),
+	_streaming(false)
 {
 	open_device();
 	init_device(videoStandard, input);
@@ -77,19 +103,60 @@ V4L2Grabber::~V4L2Grabber()
 	stop();
 	uninit_device();
 	close_device();
+
+	delete _captureThread;
+}
+
+void V4L2Grabber::setCaptureThread(bool enable)
+{
+	if (enable && _captureThread == nullptr)
+	{
+		_captureThread = new CaptureThread(this);
+	}
+	else if (!enable && _captureThread != nullptr && !_capturing && !_streaming)
+	{
+		delete _captureThread;
+		_captureThread = nullptr;
+	}
+}
+
+void V4L2Grabber::setBorderCrop(int rows, int columns)
+{
+	int xOffset, yOffset, outputWidth, outputHeight;
+	get_output_area(xOffset, yOffset, outputWidth, outputHeight);
+
+	// keep at least one row and one column of the picture
+	_borderCropRows = std::max(0, std::min(rows, (outputHeight - 1) / 2));
+	_borderCropColumns = std::max(0, std::min(columns, (outputWidth - 1) / 2));
+}
+
+int V4L2Grabber::getBorderCropRows() const
+{
+	return _borderCropRows;
+}
+
+int V4L2Grabber::getBorderCropColumns() const
+{
+	return _borderCropColumns;
 }
 
 void V4L2Grabber::setCropping(int cropLeft, int cropRight, int cropTop, int cropBottom)
 {
-	_cropLeft = cropLeft;
-	_cropRight = cropRight;
-	_cropTop = cropTop;
-	_cropBottom = cropBottom;
+	renegotiate([=]()
+	{
+		_cropLeft = cropLeft;
+		_cropRight = cropRight;
+		_cropTop = cropTop;
+		_cropBottom = cropBottom;
+	});
 }
 
 void V4L2Grabber::set3D(VideoMode mode)
 {
-	_mode3D = mode;
+	renegotiate([=]()
+	{
+		_mode3D = mode;
+	});
 }
 
 void V4L2Grabber::setSignalThreshold(double redSignalThreshold, double greenSignalThreshold, double blueSignalThreshold, int noSignalCounterThreshold)
@@ -104,8 +171,30 @@ void V4L2Grabber::setSignalThreshold(double redSignalThreshold, double greenSign
 
 void V4L2Grabber::start()
 {
-	if (_streamNotifier != nullptr && !_streamNotifier->isEnabled())
+	if (_captureThread != nullptr)
+	{
+		if (!_capturing)
+		{
+			// stop the stream of a capture thread which ended on an error
+			stop();
+
+			if (_negotiate)
+			{
+				negotiate_capture();
+			}
+			start_capturing();
+			_streaming = true;
+			_capturing = true;
+			_captureThread->start();
+			std::cout << "V4L2 grabber started on capture thread" << std::endl;
+		}
+	}
+	else if (_streamNotifier != nullptr && !_streamNotifier->isEnabled())
 	{
+		if (_negotiate)
+		{
+			negotiate_capture();
+		}
 		_streamNotifier->setEnabled(true);
 		start_capturing();
 		std::cout << "V4L2 grabber started" << std::endl;
@@ -114,7 +203,19 @@ void V4L2Grabber::start()
 
 void V4L2Grabber::stop()
 {
-	if (_streamNotifier != nullptr && _streamNotifier->isEnabled())
+	if (_captureThread != nullptr)
+	{
+		// the capture loop may already have ended on an error; the stream is stopped either way
+		_capturing = false;
+		if (_streaming)
+		{
+			_captureThread->wait();
+			_streaming = false;
+			stop_capturing();
+			std::cout << "V4L2 grabber stopped" << std::endl;
+		}
+	}
+	else if (_streamNotifier != nullptr && _streamNotifier->isEnabled())
 	{
 		stop_capturing();
 		_streamNotifier->setEnabled(false);
@@ -430,6 +531,8 @@ void V4L2Grabber::init_device(VideoStandard videoStandard, int input)
 	// store width & height
 	_width = fmt.fmt.pix.width;
 	_height = fmt.fmt.pix.height;
+	_fullWidth = _width;
+	_fullHeight = _height;
 
 	// print the eventually used width and height
 	std::cout << "V4L2 width=" << _width << " height=" << _height << std::endl;
@@ -456,9 +559,14 @@ void V4L2Grabber::init_device(VideoStandard videoStandard, int input)
 		throw_exception("Only pixel formats UYVY, YUYV, and RGB32 are supported");
 	}
 
+	init_buffers(fmt.fmt.pix.sizeimage);
+}
+
+void V4L2Grabber::init_buffers(unsigned int buffer_size)
+{
 	switch (_ioMethod) {
 	case IO_METHOD_READ:
-		init_read(fmt.fmt.pix.sizeimage);
+		init_read(buffer_size);
 		break;
 
 	case IO_METHOD_MMAP:
@@ -466,7 +574,7 @@ void V4L2Grabber::init_device(VideoStandard videoStandard, int input)
 		break;
 
 	case IO_METHOD_USERPTR:
-		init_userp(fmt.fmt.pix.sizeimage);
+		init_userp(buffer_size);
 		break;
 	}
 }
@@ -493,6 +601,267 @@ void V4L2Grabber::uninit_device()
 	_buffers.resize(0);
 }
 
+void V4L2Grabber::negotiate_capture()
+{
+	// start from doing everything in software
+	_softwareCropLeft = _cropLeft;
+	_softwareCropRight = _cropRight;
+	_softwareCropTop = _cropTop;
+	_softwareCropBottom = _cropBottom;
+	_softwareHorizontalDecimation = _horizontalPixelDecimation;
+	_softwareVerticalDecimation = _verticalPixelDecimation;
+	_softwareFrameDecimation = _frameDecimation;
+	_borderCropRows = 0;
+	_borderCropColumns = 0;
+	_currentFrame = 0;
+	_negotiate = false;
+
+	// the buffers have to be released before the format can be changed
+	uninit_device();
+	if (_ioMethod != IO_METHOD_READ)
+	{
+		struct v4l2_requestbuffers req;
+		CLEAR(req);
+		req.count = 0;
+		req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+		req.memory = (_ioMethod == IO_METHOD_MMAP) ? V4L2_MEMORY_MMAP : V4L2_MEMORY_USERPTR;
+		xioctl(VIDIOC_REQBUFS, &req);
+	}
+
+	// the 3D modes split the frame in software, so the frame is only cropped and scaled in 2D mode
+	const bool cropped = set_hardware_crop();
+	set_hardware_size(cropped);
+	set_frame_interval();
+
+	std::cout << "V4L2 software crop=" << _softwareCropLeft << "," << _softwareCropRight << "," << _softwareCropTop << "," << _softwareCropBottom
+			  << " decimation=" << _softwareHorizontalDecimation << "x" << _softwareVerticalDecimation << " frame decimation=" << _softwareFrameDecimation << std::endl;
+
+	struct v4l2_format fmt;
+	CLEAR(fmt);
+	fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+	if (-1 == xioctl(VIDIOC_G_FMT, &fmt))
+	{
+		throw_errno_exception("VIDIOC_G_FMT");
+	}
+
+	// the driver may pad the lines of the frame (0 when the driver does not report it)
+	const int pixelSize = (_pixelFormat == PIXELFORMAT_RGB32) ? 4 : 2;
+	_bytesPerLine = std::max(int(fmt.fmt.pix.bytesperline), _width * pixelSize);
+
+	// the frame has to hold all rows (the last row may come without padding)
+	_frameByteSize = _bytesPerLine * (_height - 1) + _width * pixelSize;
+
+	init_buffers(fmt.fmt.pix.sizeimage);
+}
+
+bool V4L2Grabber::set_hardware_crop()
+{
+	struct v4l2_cropcap cropcap;
+	CLEAR(cropcap);
+	cropcap.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+	if (-1 == xioctl(VIDIOC_CROPCAP, &cropcap))
+	{
+		// cropping not supported
+		return false;
+	}
+
+	// the crop rectangle in the coordinates of the device
+	const struct v4l2_rect & bounds = cropcap.defrect;
+	struct v4l2_rect rect = bounds;
+	const bool crop = _mode3D == VIDEO_2D && (_cropLeft > 0 || _cropRight > 0 || _cropTop > 0 || _cropBottom > 0);
+	if (crop)
+	{
+		const int width = bounds.width;
+		const int height = bounds.height;
+		rect.left   = bounds.left + _cropLeft * width  / _fullWidth;
+		rect.top    = bounds.top  + _cropTop  * height / _fullHeight;
+		rect.width  = std::max(1, width  - (_cropLeft + _cropRight)  * width  / _fullWidth);
+		rect.height = std::max(1, height - (_cropTop  + _cropBottom) * height / _fullHeight);
+	}
+
+	bool accepted = false;
+#ifdef VIDIOC_S_SELECTION
+	struct v4l2_selection selection;
+	CLEAR(selection);
+	selection.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+	selection.target = V4L2_SEL_TGT_CROP;
+	selection.r = rect;
+	if (0 == xioctl(VIDIOC_S_SELECTION, &selection))
+	{
+		accepted = selection.r.left == rect.left && selection.r.top == rect.top && selection.r.width == rect.width && selection.r.height == rect.height;
+	}
+	else
+#endif
+	{
+		struct v4l2_crop c;
+		CLEAR(c);
+		c.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+		c.c = rect;
+		if (0 == xioctl(VIDIOC_S_CROP, &c) && 0 == xioctl(VIDIOC_G_CROP, &c))
+		{
+			accepted = c.c.left == rect.left && c.c.top == rect.top && c.c.width == rect.width && c.c.height == rect.height;
+		}
+	}
+
+	if (!crop)
+	{
+		return false;
+	}
+
+	if (!accepted)
+	{
+		// restore the full frame; the frame is cropped in software
+		struct v4l2_crop c;
+		CLEAR(c);
+		c.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+		c.c = bounds;
+		xioctl(VIDIOC_S_CROP, &c);
+		return false;
+	}
+
+	_softwareCropLeft = 0;
+	_softwareCropRight = 0;
+	_softwareCropTop = 0;
+	_softwareCropBottom = 0;
+	std::cout << "V4L2 hardware crop=" << rect.left << "," << rect.top << " " << rect.width << "x" << rect.height << std::endl;
+	return true;
+}
+
+void V4L2Grabber::set_hardware_size(bool cropped)
+{
+	// the size of the part of the frame that is delivered
+	const int sourceWidth  = std::max(1, cropped ? _fullWidth  - _cropLeft - _cropRight  : _fullWidth);
+	const int sourceHeight = std::max(1, cropped ? _fullHeight - _cropTop  - _cropBottom : _fullHeight);
+
+	struct v4l2_format fmt;
+	CLEAR(fmt);
+	fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+	if (-1 == xioctl(VIDIOC_G_FMT, &fmt))
+	{
+		throw_errno_exception("VIDIOC_G_FMT");
+	}
+
+	// let the device scale the frame when it is decimated (the 3D modes decimate in software)
+	if (_mode3D == VIDEO_2D)
+	{
+		fmt.fmt.pix.width  = std::max(1, sourceWidth  / _horizontalPixelDecimation);
+		fmt.fmt.pix.height = std::max(1, sourceHeight / _verticalPixelDecimation);
+	}
+	else
+	{
+		fmt.fmt.pix.width  = _fullWidth;
+		fmt.fmt.pix.height = _fullHeight;
+	}
+
+	// the device may adjust the size or refuse it, in which case the current size is kept
+	if (-1 == xioctl(VIDIOC_S_FMT, &fmt))
+	{
+		std::cerr << "V4L2 grabber: VIDIOC_S_FMT " << fmt.fmt.pix.width << "x" << fmt.fmt.pix.height << " failed: " << strerror(errno) << std::endl;
+	}
+	if (-1 == xioctl(VIDIOC_G_FMT, &fmt))
+	{
+		throw_errno_exception("VIDIOC_G_FMT");
+	}
+
+	// some devices (webcams) switch to another sensor mode for a smaller size, which changes the
+	// field of view; the frame is then captured at the size of the source and scaled in software
+	const int64_t expectedWidth = int64_t(fmt.fmt.pix.height) * sourceWidth / sourceHeight;
+	if (std::abs(int64_t(fmt.fmt.pix.width) - expectedWidth) > std::max<int64_t>(1, fmt.fmt.pix.width / 50))
+	{
+		std::cerr << "V4L2 grabber: the device changed the aspect ratio to " << fmt.fmt.pix.width << "x" << fmt.fmt.pix.height
+				  << "; scaling in software" << std::endl;
+
+		fmt.fmt.pix.width  = sourceWidth;
+		fmt.fmt.pix.height = sourceHeight;
+		if (-1 == xioctl(VIDIOC_S_FMT, &fmt))
+		{
+			std::cerr << "V4L2 grabber: VIDIOC_S_FMT " << sourceWidth << "x" << sourceHeight << " failed: " << strerror(errno) << std::endl;
+		}
+		if (-1 == xioctl(VIDIOC_G_FMT, &fmt))
+		{
+			throw_errno_exception("VIDIOC_G_FMT");
+		}
+	}
+
+	_width = fmt.fmt.pix.width;
+	_height = fmt.fmt.pix.height;
+
+	// decimate the delivered frame for the remaining part in software
+	_softwareHorizontalDecimation = std::max(1, (_horizontalPixelDecimation * _width + sourceWidth/2) / sourceWidth);
+	_softwareVerticalDecimation = std::max(1, (_verticalPixelDecimation * _height + sourceHeight/2) / sourceHeight);
+	if (!cropped)
+	{
+		// scale the software crop to the delivered frame
+		_softwareCropLeft = _cropLeft * _width / _fullWidth;
+		_softwareCropRight = _cropRight * _width / _fullWidth;
+		_softwareCropTop = _cropTop * _height / _fullHeight;
+		_softwareCropBottom = _cropBottom * _height / _fullHeight;
+	}
+
+	std::cout << "V4L2 width=" << _width << " height=" << _height << std::endl;
+}
+
+void V4L2Grabber::set_frame_interval()
+{
+	struct v4l2_streamparm parm;
+	CLEAR(parm);
+	parm.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+	if (-1 == xioctl(VIDIOC_G_PARM, &parm) || !(parm.parm.capture.capability & V4L2_CAP_TIMEPERFRAME))
+	{
+		// frame interval not supported
+		return;
+	}
+
+	struct v4l2_fract & interval = parm.parm.capture.timeperframe;
+	if (_defaultIntervalDenominator == 0)
+	{
+		_defaultIntervalNumerator = interval.numerator;
+		_defaultIntervalDenominator = interval.denominator;
+	}
+	if (_defaultIntervalNumerator == 0 || _defaultIntervalDenominator == 0)
+	{
+		return;
+	}
+
+	// ask for every n-th frame only
+	interval.numerator = _defaultIntervalNumerator * _frameDecimation;
+	interval.denominator = _defaultIntervalDenominator;
+	if (-1 == xioctl(VIDIOC_S_PARM, &parm) || interval.numerator == 0 || interval.denominator == 0)
+	{
+		return;
+	}
+
+	// skip the frames the device still delivers too many in software
+	const double achieved = double(interval.numerator) * _defaultIntervalDenominator / (double(interval.denominator) * _defaultIntervalNumerator);
+	_softwareFrameDecimation = std::max(1, int(_frameDecimation / achieved + 0.5));
+
+	std::cout << "V4L2 frame interval=" << interval.numerator << "/" << interval.denominator << std::endl;
+}
+
+bool V4L2Grabber::is_capturing() const
+{
+	return (_captureThread != nullptr) ? bool(_capturing) : (_streamNotifier != nullptr && _streamNotifier->isEnabled());
+}
+
+void V4L2Grabber::renegotiate(const std::function<void()> & update)
+{
+	// the capture thread reads the settings, so they are only changed while it is stopped
+	const bool capturing = is_capturing();
+	if (capturing)
+	{
+		stop();
+	}
+
+	update();
+	_negotiate = true;
+
+	// apply the new settings to a running capture immediately
+	if (capturing)
+	{
+		start();
+	}
+}
+
 void V4L2Grabber::start_capturing()
 {
 	switch (_ioMethod) {
@@ -559,6 +928,42 @@ void V4L2Grabber::stop_capturing()
 	}
 }
 
+void V4L2Grabber::capture_loop()
+{
+	while (_capturing)
+	{
+		// wait for a frame (with a timeout to notice the stop request)
+		struct pollfd descriptor;
+		descriptor.fd = _fileDescriptor;
+		descriptor.events = POLLIN;
+		descriptor.revents = 0;
+
+		const int result = poll(&descriptor, 1, 100);
+		if (result == -1 && errno != EINTR)
+		{
+			std::cerr << "V4L2 grabber: poll error " << errno << ", " << strerror(errno) << std::endl;
+			_capturing = false;
+			emit captureFailed();
+			return;
+		}
+
+		if (result > 0)
+		{
+			try
+			{
+				read_frame();
+			}
+			catch (const std::exception & e)
+			{
+				std::cerr << "V4L2 grabber: " << e.what() << std::endl;
+				_capturing = false;
+				emit captureFailed();
+				return;
+			}
+		}
+	}
+}
+
 int V4L2Grabber::read_frame()
 {
 	bool rc = false;
@@ -667,13 +1072,13 @@ int V4L2Grabber::read_frame()
 
 bool V4L2Grabber::process_image(const void *p, int size)
 {
-	if (++_currentFrame >= _frameDecimation)
+	if (++_currentFrame >= _softwareFrameDecimation)
 	{
 		// We do want a new frame...
 
-		if (size != _frameByteSize)
+		if (size < _frameByteSize)
 		{
-			std::cout << "Frame too small: " << size << " != " << _frameByteSize << std::endl;
+			std::cout << "Frame too small: " << size << " < " << _frameByteSize << std::endl;
 		}
 		else
 		{
@@ -687,6 +1092,57 @@ bool V4L2Grabber::process_image(const void *p, int size)
 }
 
 void V4L2Grabber::process_image(const uint8_t * data)
+{
+	int xOffset, yOffset, outputWidth, outputHeight;
+	get_output_area(xOffset, yOffset, outputWidth, outputHeight);
+
+	// skip the black border (limited by setBorderCrop to leave a picture)
+	yOffset += _borderCropRows * _softwareVerticalDecimation;
+	outputHeight -= 2 * _borderCropRows;
+	xOffset += _borderCropColumns * _softwareHorizontalDecimation;
+	outputWidth -= 2 * _borderCropColumns;
+
+	// hand yuv frames over without conversion when a receiver can process them directly
+	if ((_pixelFormat == PIXELFORMAT_YUYV || _pixelFormat == PIXELFORMAT_UYVY) && receivers(SIGNAL(newYuvFrame(YuvImage))) > 0)
+	{
+		const YuvImage image(data, _bytesPerLine, _pixelFormat == PIXELFORMAT_UYVY,
+				outputWidth, outputHeight,
+				xOffset, yOffset,
+				_softwareHorizontalDecimation, _softwareVerticalDecimation);
+
+		if (check_signal(image))
+		{
+			emit newYuvFrame(image);
+		}
+		return;
+	}
+
+	Image<ColorRgb> image(outputWidth, outputHeight);
+
+	// convert the cropped and decimated part of the frame (the format is only checked once per frame)
+	switch (_pixelFormat)
+	{
+	case PIXELFORMAT_UYVY:
+		convertFrame<PIXELLAYOUT_UYVY>(data, _bytesPerLine, xOffset, yOffset, _softwareHorizontalDecimation, _softwareVerticalDecimation, image);
+		break;
+	case PIXELFORMAT_YUYV:
+		convertFrame<PIXELLAYOUT_YUYV>(data, _bytesPerLine, xOffset, yOffset, _softwareHorizontalDecimation, _softwareVerticalDecimation, image);
+		break;
+	case PIXELFORMAT_RGB32:
+		convertFrame<PIXELLAYOUT_RGB32>(data, _bytesPerLine, xOffset, yOffset, _softwareHorizontalDecimation, _softwareVerticalDecimation, image);
+		break;
+	default:
+		// this should not be possible
+		break;
+	}
+
+	if (check_signal(image))
+	{
+		emit newFrame(image);
+	}
+}
+
+void V4L2Grabber::get_output_area(int & xOffset, int & yOffset, int & outputWidth, int & outputHeight) const
 {
 	int width = _width;
 	int height = _height;
@@ -703,52 +1159,16 @@ void V4L2Grabber::process_image(const uint8_t * data)
 		break;
 	}
 
-	// create output structure
-	int outputWidth = (width - _cropLeft - _cropRight + _horizontalPixelDecimation/2) / _horizontalPixelDecimation;
-	int outputHeight = (height - _cropTop - _cropBottom + _verticalPixelDecimation/2) / _verticalPixelDecimation;
-	Image<ColorRgb> image(outputWidth, outputHeight);
-
-	for (int ySource = _cropTop + _verticalPixelDecimation/2, yDest = 0; ySource < height - _cropBottom; ySource += _verticalPixelDecimation, ++yDest)
-	{
-		for (int xSource = _cropLeft + _horizontalPixelDecimation/2, xDest = 0; xSource < width - _cropRight; xSource += _horizontalPixelDecimation, ++xDest)
-		{
-			ColorRgb & rgb = image(xDest, yDest);
-
-			switch (_pixelFormat)
-			{
-			case PIXELFORMAT_UYVY:
-				{
-					int index = (_width * ySource + xSource) * 2;
-					uint8_t y = data[index+1];
-					uint8_t u = (xSource%2 == 0) ? data[index  ] : data[index-2];
-					uint8_t v = (xSource%2 == 0) ? data[index+2] : data[index  ];
-					yuv2rgb(y, u, v, rgb.red, rgb.green, rgb.blue);
-				}
-				break;
-			case PIXELFORMAT_YUYV:
-				{
-					int index = (_width * ySource + xSource) * 2;
-					uint8_t y = data[index];
-					uint8_t u = (xSource%2 == 0) ? data[index+1] : data[index-1];
-					uint8_t v = (xSource%2 == 0) ? data[index+3] : data[index+1];
-					yuv2rgb(y, u, v, rgb.red, rgb.green, rgb.blue);
-				}
-				break;
-			case PIXELFORMAT_RGB32:
-				{
-					int index = (_width * ySource + xSource) * 4;
-					rgb.red   = data[index  ];
-					rgb.green = data[index+1];
-					rgb.blue  = data[index+2];
-				}
-				break;
-			default:
-				// this should not be possible
-				break;
-			}
-		}
-	}
+	// the first sampled pixel and the number of sampled pixels (which all lie within the cropped frame)
+	xOffset = _softwareCropLeft + _softwareHorizontalDecimation/2;
+	yOffset = _softwareCropTop + _softwareVerticalDecimation/2;
+	outputWidth = std::max(1, (width - _softwareCropRight - xOffset + _softwareHorizontalDecimation - 1) / _softwareHorizontalDecimation);
+	outputHeight = std::max(1, (height - _softwareCropBottom - yOffset + _softwareVerticalDecimation - 1) / _softwareVerticalDecimation);
+}
 
+template <typename Image_T>
+bool V4L2Grabber::check_signal(const Image_T & image)
+{
 	// check signal (only in center of the resulting image, because some grabbers have noise values along the borders)
 	bool noSignal = true;
 	for (unsigned x = 0; noSignal && x < (image.width()>>1); ++x)
@@ -759,7 +1179,7 @@ void V4L2Grabber::process_image(const uint8_t * data)
 		{
 			int yImage = (image.height()>>2) + y;
 
-			ColorRgb & rgb = image(xImage, yImage);
+			const ColorRgb rgb = image(xImage, yImage);
 			noSignal &= rgb <= _noSignalThresholdColor;
 		}
 	}
@@ -780,12 +1200,14 @@ void V4L2Grabber::process_image(const uint8_t * data)
 
 	if (_noSignalCounter < _noSignalCounterThreshold)
 	{
-		emit newFrame(image);
+		return true;
 	}
 	else if (_noSignalCounter == _noSignalCounterThreshold)
 	{
 		std::cout << "V4L2 Grabber: " << "Signal lost" << std::endl;
 	}
+
+	return false;
 }
 
 int V4L2Grabber::xioctl(int request, void *arg)
@@ -1,3 +1,7 @@
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
 #include <QMetaType>
 
 #include <grabber/V4L2Wrapper.h>
@@ -15,9 +19,9 @@ V4L2Wrapper::V4L2Wrapper(const std::string &device,
 		double redSignalThreshold,
 		double greenSignalThreshold,
 		double blueSignalThreshold,
+		bool captureThread,
 		Hyperion *hyperion,
 		int hyperionPriority) :
-	_timeout_ms(1000),
 	_priority(hyperionPriority),
 	_grabber(device,
 			input,
@@ -29,9 +33,13 @@ V4L2Wrapper::V4L2Wrapper(const std::string &device,
 			pixelDecimation,
 			pixelDecimation),
 	_processor(ImageProcessorFactory::getInstance().newImageProcessor()),
+	_borderCropRows(0),
+	_borderCropColumns(0),
 	_hyperion(hyperion),
-	_ledColors(hyperion->getLedCount(), ColorRgb{0,0,0}),
-	_timer()
+	_timer(),
+	_retryTimer(),
+	_retryDelay_ms(0),
+	_channel(hyperion, hyperionPriority, 1000)
 {
 	// set the signal detection threshold of the grabber
 	_grabber.setSignalThreshold(
@@ -42,7 +50,6 @@ V4L2Wrapper::V4L2Wrapper(const std::string &device,
 
 	// register the image type
 	qRegisterMetaType<Image<ColorRgb>>("Image<ColorRgb>");
-	qRegisterMetaType<std::vector<ColorRgb>>("std::vector<ColorRgb>");
 
 	// Handle the image in the captured thread using a direct connection
 	QObject::connect(
@@ -50,11 +57,15 @@ V4L2Wrapper::V4L2Wrapper(const std::string &device,
 				this, SLOT(newFrame(Image<ColorRgb>)),
 				Qt::DirectConnection);
 
-	// send color data to Hyperion using a queued connection to handle the data over to the main event loop
+	// Compute the led colors straight from yuv capture buffers (the buffer is only valid during the call)
 	QObject::connect(
-				this, SIGNAL(emitColors(int,std::vector<ColorRgb>,int)),
-				_hyperion, SLOT(setColors(int,std::vector<ColorRgb>,int)),
-				Qt::QueuedConnection);
+				&_grabber, SIGNAL(newYuvFrame(YuvImage)),
+				this, SLOT(newYuvFrame(YuvImage)),
+				Qt::DirectConnection);
+
+	// the frames are processed on the capture thread when enabled; the led colors are handed over
+	// to Hyperion through the channel either way
+	_grabber.setCaptureThread(captureThread);
 
 	// setup the higher prio source checker
 	// this will disable the v4l2 grabber when a source with hisher priority is active
@@ -62,6 +73,12 @@ V4L2Wrapper::V4L2Wrapper(const std::string &device,
 	_timer.setSingleShot(false);
 	QObject::connect(&_timer, SIGNAL(timeout()), this, SLOT(checkSources()));
 	_timer.start();
+
+	// restart the grabber (if no higher priority source is active) with an increasing delay when
+	// the capture thread stopped on an error
+	_retryTimer.setSingleShot(true);
+	QObject::connect(&_retryTimer, SIGNAL(timeout()), this, SLOT(checkSources()));
+	QObject::connect(&_grabber, SIGNAL(captureFailed()), this, SLOT(captureFailed()), Qt::QueuedConnection);
 }
 
 V4L2Wrapper::~V4L2Wrapper()
@@ -91,27 +108,108 @@ void V4L2Wrapper::set3D(VideoMode mode)
 
 void V4L2Wrapper::newFrame(const Image<ColorRgb> &image)
 {
+	// the capture works (again)
+	_retryDelay_ms = 0;
+
+	syncBorderCrop();
+
 	// process the new image
-	_processor->process(image, _ledColors);
+	_processor->process(image, _channel.producerSlot());
+
+	// send colors to Hyperion
+	_channel.publish();
+
+	cropBorder();
+}
+
+void V4L2Wrapper::newYuvFrame(const YuvImage &image)
+{
+	// the capture works (again)
+	_retryDelay_ms = 0;
+
+	syncBorderCrop();
+
+	// process the frame without converting it
+	_processor->process(image, _channel.producerSlot());
 
 	// send colors to Hyperion
-	emit emitColors(_priority, _ledColors, _timeout_ms);
+	_channel.publish();
+
+	cropBorder();
+}
+
+void V4L2Wrapper::syncBorderCrop()
+{
+	const int cropRows = _grabber.getBorderCropRows();
+	const int cropColumns = _grabber.getBorderCropColumns();
+
+	if (cropRows != _borderCropRows || cropColumns != _borderCropColumns)
+	{
+		_processor->shiftBorder(cropRows - _borderCropRows, cropColumns - _borderCropColumns);
+		_borderCropRows = cropRows;
+		_borderCropColumns = cropColumns;
+	}
+}
+
+void V4L2Wrapper::cropBorder()
+{
+	// the number of border pixels left in the frames
+	const int margin = 2;
+
+	const hyperion::BlackBorder border = _processor->getCurrentBorder();
+
+	// grow the crop to the border minus the margin; restore the complete frame when the picture
+	// reaches into the margin (the border is detected again on the complete frame)
+	const int rows = (border.unknown || border.horizontalSize < margin) ? 0 : _borderCropRows + border.horizontalSize - margin;
+	const int columns = (border.unknown || border.verticalSize < margin) ? 0 : _borderCropColumns + border.verticalSize - margin;
+
+	if (rows != _borderCropRows || columns != _borderCropColumns)
+	{
+		// the processor is shifted by the crop which the grabber actually applied
+		_grabber.setBorderCrop(rows, columns);
+		syncBorderCrop();
+	}
 }
 
 void V4L2Wrapper::checkSources()
 {
 	QList<int> activePriorities = _hyperion->getActivePriorities();
 
-	for (int x : activePriorities)
+	try
 	{
-		if (x < _priority)
+		for (int x : activePriorities)
 		{
-			// found a higher priority source: grabber should be disabled
-			_grabber.stop();
-			return;
+			if (x < _priority)
+			{
+				// found a higher priority source: grabber should be disabled
+				_grabber.stop();
+				return;
+			}
+		}
+
+		// no higher priority source was found: grabber should be enabled (unless it is waiting to
+		// be restarted after a failure)
+		if (!_retryTimer.isActive())
+		{
+			_grabber.start();
 		}
 	}
+	catch (const std::exception & e)
+	{
+		// the device may (temporarily) be unavailable; an exception must not escape the slot
+		std::cerr << "V4L2 grabber: " << e.what() << std::endl;
+		captureFailed();
+	}
+}
 
-	// no higher priority source was found: grabber should be enabled
-	_grabber.start();
+void V4L2Wrapper::captureFailed()
+{
+	const int minDelay_ms = 500;
+	const int maxDelay_ms = 30000;
+
+	const int delay_ms = std::min(std::max(minDelay_ms, 2 * _retryDelay_ms), maxDelay_ms);
+	_retryDelay_ms = delay_ms;
+	_retryTimer.start(delay_ms);
+
+	std::cerr << "V4L2 grabber: capture failed, retrying in " << delay_ms << " ms" << std::endl;
 }
@@ -0,0 +1,146 @@
+
+// Hyperion includes
+#include "ColorTransformTable.h"
+
+namespace
+{
+	/// The distance between two lattice points along a color axis
+	const unsigned LATTICE_STEP = 8;
+
+	///
+	/// Returns the channel value of the given lattice point. The last point is at 255, which makes
+	/// the last cell one value shorter but keeps full white exact.
+	///
+	inline unsigned latticeValue(unsigned point)
+	{
+		const unsigned value = point * LATTICE_STEP;
+		return value > 255 ? 255 : value;
+	}
+
+	///
+	/// The lattice cell and the (8 bit fixed point) position within that cell of every channel value
+	///
+	struct LatticeCells
+	{
+		LatticeCells()
+		{
+			for (unsigned value = 0; value < 256; ++value)
+			{
+				const unsigned point = value / LATTICE_STEP;
+				const unsigned width = latticeValue(point + 1) - latticeValue(point);
+				cell[value] = point;
+				weight[value] = ((value - latticeValue(point)) * 256 + width/2) / width;
+			}
+		}
+
+		unsigned cell[256];
+		int weight[256];
+	};
+
+	const LatticeCells latticeCells;
+
+	/// Interpolates between a and b with an 8 bit fixed point weight (result scaled by 256)
+	inline int lerp(int a, int b, int weight)
+	{
+		return a * 256 + (b - a) * weight;
+	}
+}
+
+ColorTransformTable::ColorTransformTable() :
+	_lattice()
+{
+	for (unsigned i = 0; i < 256; ++i)
+	{
+		_red[i] = _green[i] = _blue[i] = i;
+	}
+}
+
+void ColorTransformTable::compile(const ColorTransform & transform)
+{
+	for (unsigned i = 0; i < 256; ++i)
+	{
+		_red[i]   = transform._rgbRedTransform.transform(i);
+		_green[i] = transform._rgbGreenTransform.transform(i);
+		_blue[i]  = transform._rgbBlueTransform.transform(i);
+	}
+
+	const HsvTransform & hsvTransform = transform._hsvTransform;
+	if (hsvTransform.getSaturationGain() == 1.0 && hsvTransform.getValueGain() == 1.0)
+	{
+		// The hsv transform has no effect, the per channel tables are exact
+		std::vector<ColorRgb>().swap(_lattice);
+		return;
+	}
+
+	_lattice.resize(LATTICE_SIZE * LATTICE_SIZE * LATTICE_SIZE);
+	ColorRgb * latticeColor = _lattice.data();
+	for (unsigned r = 0; r < LATTICE_SIZE; ++r)
+	{
+		for (unsigned g = 0; g < LATTICE_SIZE; ++g)
+		{
+			for (unsigned b = 0; b < LATTICE_SIZE; ++b)
+			{
+				uint8_t red   = latticeValue(r);
+				uint8_t green = latticeValue(g);
+				uint8_t blue  = latticeValue(b);
+				hsvTransform.transform(red, green, blue);
+				*latticeColor++ = ColorRgb{_red[red], _green[green], _blue[blue]};
+			}
+		}
+	}
+}
+
+void ColorTransformTable::transform(ColorRgb * colors, unsigned count) const
+{
+	ColorRgb * end = colors + count;
+	if (_lattice.empty())
+	{
+		for (ColorRgb * color = colors; color != end; ++color)
+		{
+			color->red   = _red[color->red];
+			color->green = _green[color->green];
+			color->blue  = _blue[color->blue];
+		}
+	}
+	else
+	{
+		for (ColorRgb * color = colors; color != end; ++color)
+		{
+			*color = interpolate(*color);
+		}
+	}
+}
+
+ColorRgb ColorTransformTable::interpolate(const ColorRgb & color) const
+{
+	const unsigned strideGreen = LATTICE_SIZE;
+	const unsigned strideRed   = LATTICE_SIZE * LATTICE_SIZE;
+
+	const int wr = latticeCells.weight[color.red];
+	const int wg = latticeCells.weight[color.green];
+	const int wb = latticeCells.weight[color.blue];
+
+	const ColorRgb * c000 = &_lattice[(latticeCells.cell[color.red]*LATTICE_SIZE + latticeCells.cell[color.green])*LATTICE_SIZE + latticeCells.cell[color.blue]];
+	const ColorRgb * c100 = c000 + strideRed;
+	const ColorRgb * c010 = c000 + strideGreen;
+	const ColorRgb * c110 = c100 + strideGreen;
+
+	// Interpolate along red, then green (both with 8 bit fixed point) and finally blue
+	const uint8_t ColorRgb::* channels[3] = { &ColorRgb::red, &ColorRgb::green, &ColorRgb::blue };
+	uint8_t result[3];
+	for (unsigned i = 0; i < 3; ++i)
+	{
+		const uint8_t ColorRgb::* channel = channels[i];
+
+		const int x00 = lerp(c000[0].*channel, c100[0].*channel, wr);
+		const int x10 = lerp(c010[0].*channel, c110[0].*channel, wr);
+		const int x01 = lerp(c000[1].*channel, c100[1].*channel, wr);
+		const int x11 = lerp(c010[1].*channel, c110[1].*channel, wr);
+
+		const int y0 = (lerp(x00, x10, wg) + 128) >> 8;
+		const int y1 = (lerp(x01, x11, wg) + 128) >> 8;
+
+		result[i] = uint8_t((lerp(y0, y1, wb) + 32768) >> 16);
+	}
+	return ColorRgb{result[0], result[1], result[2]};
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+// STL includes
+#include <cstdint>
+#include <vector>
+
+// Utils includes
+#include <utils/ColorRgb.h>
+
+// Hyperion includes
+#include <hyperion/ColorTransform.h>
+
+///
+/// The ColorTransformTable is the compiled form of a ColorTransform. Transforming a color with the
+/// table is a single lookup, independent of the number of configured stages:
+///  - when the HSV transform has no effect, the transform is separable in the color channels and
+///    compiled into an exact table per channel;
+///  - otherwise the transform is sampled on a lattice of 33x33x33 colors and a color is
+///    transformed by trilinear interpolation between the eight surrounding lattice colors.
+///
+/// The table must be recompiled when the parameters of the ColorTransform change.
+///
+class ColorTransformTable
+{
+public:
+	/// The number of lattice points along each color axis
+	static const unsigned LATTICE_SIZE = 33;
+
+	///
+	/// Constructs an identity table
+	///
+	ColorTransformTable();
+
+	///
+	/// (Re)compiles the table from the current parameters of the given transform
+	///
+	/// @param transform The ColorTransform to compile
+	///
+	void compile(const ColorTransform & transform);
+
+	///
+	/// Transforms the given color
+	///
+	/// @param color The color to transform
+	///
+	/// @return The transformed color
+	///
+	inline ColorRgb transform(const ColorRgb & color) const
+	{
+		if (_lattice.empty())
+		{
+			return ColorRgb{_red[color.red], _green[color.green], _blue[color.blue]};
+		}
+		return interpolate(color);
+	}
+
+	///
+	/// Transforms the given run of colors in place. The choice between the per channel tables and
+	/// the lattice is made once for the run instead of for every color.
+	///
+	/// @param colors The first color of the run
+	/// @param count The number of colors in the run
+	///
+	void transform(ColorRgb * colors, unsigned count) const;
+
+private:
+	///
+	/// Transforms the given color by trilinear interpolation on the lattice
+	///
+	ColorRgb interpolate(const ColorRgb & color) const;
+
+private:
+	/// The exact per channel tables of a separable transform
+	uint8_t _red[256];
+	uint8_t _green[256];
+	uint8_t _blue[256];
+
+	/// The transformed lattice colors, indexed by (red*LATTICE_SIZE + green)*LATTICE_SIZE + blue
+	/// (empty for a separable transform)
+	std::vector<ColorRgb> _lattice;
+};
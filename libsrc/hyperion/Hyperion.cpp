@@ -1,5 +1,6 @@
 
 // STL includes
+#include <algorithm>
 #include <cassert>
 
 // QT includes
@@ -15,6 +16,7 @@
 // hyperion include
 #include <hyperion/Hyperion.h>
 #include <hyperion/ImageProcessorFactory.h>
+#include <hyperion/LedFrameChannel.h>
 
 // Leddevice includes
 #include <leddevice/LedDevice.h>
@@ -22,6 +24,7 @@
 
 #include "MultiColorTransform.h"
 #include "LinearColorSmoothing.h"
+#include "LedDelayLine.h"
 
 // effect engine includes
 #include <effectengine/EffectEngine.h>
@@ -68,6 +71,88 @@ Hyperion::ColorOrder Hyperion::createColorOrder(const Json::Value &deviceConfig)
 	return ORDER_RGB;
 }
 
+namespace
+{
+	///
+	/// Puts the color bytes of all leds in the given order
+	///
+	/// @param[in,out] ledColors The colors to reorder
+	///
+	template <Hyperion::ColorOrder Order_T>
+	void reorderColors(std::vector<ColorRgb> & ledColors);
+
+	template <>
+	void reorderColors<Hyperion::ORDER_RGB>(std::vector<ColorRgb> &)
+	{
+		// leave as it is
+	}
+
+	template <>
+	void reorderColors<Hyperion::ORDER_BGR>(std::vector<ColorRgb> & ledColors)
+	{
+		for (ColorRgb & color : ledColors)
+		{
+			std::swap(color.red, color.blue);
+		}
+	}
+
+	template <>
+	void reorderColors<Hyperion::ORDER_RBG>(std::vector<ColorRgb> & ledColors)
+	{
+		for (ColorRgb & color : ledColors)
+		{
+			std::swap(color.green, color.blue);
+		}
+	}
+
+	template <>
+	void reorderColors<Hyperion::ORDER_GRB>(std::vector<ColorRgb> & ledColors)
+	{
+		for (ColorRgb & color : ledColors)
+		{
+			std::swap(color.red, color.green);
+		}
+	}
+
+	template <>
+	void reorderColors<Hyperion::ORDER_GBR>(std::vector<ColorRgb> & ledColors)
+	{
+		for (ColorRgb & color : ledColors)
+		{
+			color = ColorRgb{color.green, color.blue, color.red};
+		}
+	}
+
+	template <>
+	void reorderColors<Hyperion::ORDER_BRG>(std::vector<ColorRgb> & ledColors)
+	{
+		for (ColorRgb & color : ledColors)
+		{
+			color = ColorRgb{color.blue, color.red, color.green};
+		}
+	}
+}
+
+Hyperion::ColorOrderFunction Hyperion::createColorOrderFunction(const ColorOrder colorOrder)
+{
+	switch (colorOrder)
+	{
+	case ORDER_BGR:
+		return reorderColors<ORDER_BGR>;
+	case ORDER_RBG:
+		return reorderColors<ORDER_RBG>;
+	case ORDER_GRB:
+		return reorderColors<ORDER_GRB>;
+	case ORDER_GBR:
+		return reorderColors<ORDER_GBR>;
+	case ORDER_BRG:
+		return reorderColors<ORDER_BRG>;
+	case ORDER_RGB:
+	default:
+		return reorderColors<ORDER_RGB>;
+	}
+}
+
 ColorTransform * Hyperion::createColorTransform(const Json::Value & transformConfig)
 {
 	const std::string id = transformConfig.get("id", "default").asString();
@@ -221,6 +306,21 @@ LedString Hyperion::createLedString(const Json::Value& ledsConfig)
 	return ledString;
 }
 
+int64_t Hyperion::createTimeoutTime(const int timeout_ms)
+{
+	return timeout_ms > 0 ? QDateTime::currentMSecsSinceEpoch() + timeout_ms : -1;
+}
+
+qint64 Hyperion::createRenderInterval(const Json::Value & deviceConfig)
+{
+	const double frequency = deviceConfig.get("updateFrequency", 0.0).asDouble();
+	if (frequency <= 0.0)
+	{
+		return 0;
+	}
+	return qint64(1e9 / frequency);
+}
+
 LedDevice * Hyperion::createColorSmoothing(const Json::Value & smoothingConfig, LedDevice * ledDevice)
 {
 	std::string type = smoothingConfig.get("type", "none").asString();
@@ -261,27 +361,64 @@ Hyperion::Hyperion(const Json::Value &jsonConfig) :
 	_muxer(_ledString.leds().size()),
 	_raw2ledTransform(createLedColorsTransform(_ledString.leds().size(), jsonConfig["color"])),
 	_colorOrder(createColorOrder(jsonConfig["device"])),
+	_colorOrderFunction(createColorOrderFunction(_colorOrder)),
+	_ledBuffers(),
+	_ledBuffer(0),
 	_device(LedDeviceFactory::construct(jsonConfig["device"])),
+	_delayLine(nullptr),
 	_effectEngine(nullptr),
-	_timer()
+	_channels(),
+	_timer(),
+	_renderInterval_ns(createRenderInterval(jsonConfig["device"])),
+	_renderClock(),
+	_lastRender_ns(0),
+	_renderTimer(),
+	_renderDirty(false)
 {
 	if (!_raw2ledTransform->verifyTransforms())
 	{
 		throw std::runtime_error("Color transformation incorrectly set");
 	}
+	_raw2ledTransform->updateTransforms();
+
+	// allocate the led buffers once
+	_ledBuffers[0].reserve(_ledString.leds().size());
+	_ledBuffers[1].reserve(_ledString.leds().size());
 	// initialize the image processor factory
 	ImageProcessorFactory::getInstance().init(
 				_ledString,
 				jsonConfig["blackborderdetector"].get("enable", true).asBool(),
-				jsonConfig["blackborderdetector"].get("threshold", 0.01).asDouble());
+				jsonConfig["blackborderdetector"].get("threshold", 0.01).asDouble(),
+				jsonConfig["blackborderdetector"].get("interval", 1).asUInt(),
+				parseMappingEngine(jsonConfig["ledmapping"].get("engine", "auto").asString()),
+				jsonConfig["ledmapping"].get("threads", 1).asUInt(),
+				jsonConfig["ledmapping"].get("samples", 0).asUInt());
 
 	// initialize the color smoothing filter
 	_device = createColorSmoothing(jsonConfig["color"]["smoothing"], _device);
 
+	// initialize the latency compensation
+	const int delay_ms = jsonConfig["device"].get("delay_ms", 0).asInt();
+	if (delay_ms > 0)
+	{
+		std::cout << "Creating delay line of " << delay_ms << " ms" << std::endl;
+		_delayLine = new LedDelayLine(_device, delay_ms, _ledString.leds().size());
+		_device = _delayLine;
+	}
+
 	// setup the timer
 	_timer.setSingleShot(true);
 	QObject::connect(&_timer, SIGNAL(timeout()), this, SLOT(update()));
 
+	// setup the render clock
+	_renderClock.start();
+	_renderTimer.setSingleShot(true);
+	QObject::connect(&_renderTimer, SIGNAL(timeout()), this, SLOT(renderTick()));
+	if (_renderInterval_ns > 0)
+	{
+		std::cout << "Render clock: leds are written at most every " << _renderInterval_ns / 1000 << " us" << std::endl;
+	}
+
 	// create the effect engine
 	_effectEngine = new EffectEngine(this, jsonConfig["effects"]);
 
@@ -317,7 +454,7 @@ void Hyperion::setColor(int priority, const ColorRgb &color, const int timeout_m
 	std::vector<ColorRgb> ledColors(_ledString.leds().size(), color);
 
 	// set colors
-	setColors(priority, ledColors, timeout_ms, clearEffects);
+	setColors(priority, std::move(ledColors), timeout_ms, clearEffects);
 }
 
 void Hyperion::setColors(int priority, const std::vector<ColorRgb>& ledColors, const int timeout_ms, bool clearEffects)
@@ -328,22 +465,76 @@ void Hyperion::setColors(int priority, const std::vector<ColorRgb>& ledColors, c
 		_effectEngine->channelCleared(priority);
 	}
 
-	if (timeout_ms > 0)
+	_muxer.setInput(priority, ledColors, createTimeoutTime(timeout_ms));
+
+	if (priority == _muxer.getCurrentPriority())
 	{
-		const uint64_t timeoutTime = QDateTime::currentMSecsSinceEpoch() + timeout_ms;
-		_muxer.setInput(priority, ledColors, timeoutTime);
+		requestUpdate();
 	}
-	else
+}
+
+void Hyperion::setColors(int priority, std::vector<ColorRgb>&& ledColors, const int timeout_ms, bool clearEffects)
+{
+	// clear effects if this call does not come from an effect
+	if (clearEffects)
 	{
-		_muxer.setInput(priority, ledColors);
+		_effectEngine->channelCleared(priority);
 	}
 
+	_muxer.setInput(priority, std::move(ledColors), createTimeoutTime(timeout_ms));
+
 	if (priority == _muxer.getCurrentPriority())
+	{
+		requestUpdate();
+	}
+}
+
+void Hyperion::registerChannel(LedFrameChannel * channel)
+{
+	_channels.push_back(channel);
+}
+
+void Hyperion::unregisterChannel(LedFrameChannel * channel)
+{
+	_channels.erase(std::remove(_channels.begin(), _channels.end(), channel), _channels.end());
+}
+
+void Hyperion::consumeChannels()
+{
+	if (_renderInterval_ns > 0)
+	{
+		// the channels are taken on the next tick of the render clock
+		requestUpdate();
+	}
+	else if (takeChannels())
 	{
 		update();
 	}
 }
 
+bool Hyperion::takeChannels()
+{
+	bool currentChanged = false;
+	for (LedFrameChannel * channel : _channels)
+	{
+		if (!channel->take())
+		{
+			continue;
+		}
+
+		const int priority = channel->getPriority();
+		_effectEngine->channelCleared(priority);
+
+		// swap the colors into the muxer; the channel gets the previous buffer of the priority back
+		std::vector<ColorRgb> & ledColors = channel->consumerSlot();
+		_muxer.setInput(priority, std::move(ledColors), createTimeoutTime(channel->getTimeout()));
+		ledColors.resize(_ledString.leds().size());
+
+		currentChanged |= priority == _muxer.getCurrentPriority();
+	}
+	return currentChanged;
+}
+
 const std::vector<std::string> & Hyperion::getTransformIds() const
 {
 	return _raw2ledTransform->getTransformIds();
@@ -356,7 +547,8 @@ ColorTransform * Hyperion::getTransform(const std::string& id)
 
 void Hyperion::transformsUpdated()
 {
-	update();
+	_raw2ledTransform->updateTransforms();
+	requestUpdate();
 }
 
 void Hyperion::clear(int priority)
@@ -368,7 +560,7 @@ void Hyperion::clear(int priority)
 		// update leds if necessary
 		if (priority < _muxer.getCurrentPriority())
 		{
-			update();
+			requestUpdate();
 		}
 	}
 
@@ -382,7 +574,7 @@ void Hyperion::clearall()
 	_muxer.clearAll();
 
 	// update leds
-	update();
+	requestUpdate();
 
 	// send clearall signal to the effect engine
 	_effectEngine->allChannelsCleared();
@@ -403,6 +595,11 @@ const std::list<EffectDefinition> & Hyperion::getEffects() const
 	return _effectEngine->getEffects();
 }
 
+int Hyperion::getAchievedDelay() const
+{
+	return _delayLine == nullptr ? -1 : _delayLine->getAchievedDelay();
+}
+
 int Hyperion::setEffect(const std::string &effectName, int priority, int timeout)
 {
 	return _effectEngine->runEffect(effectName, priority, timeout);
@@ -413,8 +610,50 @@ int Hyperion::setEffect(const std::string &effectName, const Json::Value &args,
 	return _effectEngine->runEffect(effectName, args, priority, timeout);
 }
 
+void Hyperion::requestUpdate()
+{
+	if (_renderInterval_ns <= 0)
+	{
+		update();
+		return;
+	}
+
+	_renderDirty = true;
+	if (_renderTimer.isActive())
+	{
+		// already waiting for the next tick
+		return;
+	}
+
+	const qint64 sinceRender_ns = _renderClock.nsecsElapsed() - _lastRender_ns;
+	if (sinceRender_ns >= _renderInterval_ns)
+	{
+		// the clock was idle for at least one interval; write without delay
+		update();
+	}
+	else
+	{
+		// round up to the next millisecond, so the tick never comes early
+		_renderTimer.start(int((_renderInterval_ns - sinceRender_ns + 999999) / 1000000));
+	}
+}
+
+void Hyperion::renderTick()
+{
+	if (_renderDirty)
+	{
+		update();
+	}
+}
+
 void Hyperion::update()
 {
+	_renderDirty = false;
+	_lastRender_ns = _renderClock.nsecsElapsed();
+
+	// Take the newest colors of the channels
+	takeChannels();
+
 	// Update the muxer, cleaning obsolete priorities
 	_muxer.setCurrentTime(QDateTime::currentMSecsSinceEpoch());
 
@@ -422,47 +661,19 @@ void Hyperion::update()
 	int priority = _muxer.getCurrentPriority();
 	const PriorityMuxer::InputInfo & priorityInfo  = _muxer.getInputInfo(priority);
 
-	// Apply the transform to each led and color-channel
-	std::vector<ColorRgb> ledColors = _raw2ledTransform->applyTransform(priorityInfo.ledColors);
-	for (ColorRgb& color : ledColors)
-	{
-		// correct the color byte order
-		switch (_colorOrder)
-		{
-		case ORDER_RGB:
-			// leave as it is
-			break;
-		case ORDER_BGR:
-			std::swap(color.red, color.blue);
-			break;
-		case ORDER_RBG:
-			std::swap(color.green, color.blue);
-			break;
-		case ORDER_GRB:
-			std::swap(color.red, color.green);
-			break;
-		case ORDER_GBR:
-		{
-			uint8_t temp = color.red;
-			color.red = color.green;
-			color.green = color.blue;
-			color.blue = temp;
-			break;
-		}
-		case ORDER_BRG:
-		{
-			uint8_t temp = color.red;
-			color.red = color.blue;
-			color.blue = color.green;
-			color.green = temp;
-			break;
-		}
-		}
-	}
+	// Apply the transform to each led and color-channel into the preallocated buffer
+	std::vector<ColorRgb> & ledColors = _ledBuffers[_ledBuffer];
+	_raw2ledTransform->applyTransform(priorityInfo.ledColors, ledColors);
+
+	// correct the color byte order
+	_colorOrderFunction(ledColors);
 
 	// Write the data to the device
 	_device->write(ledColors);
 
+	// the next update fills the other buffer, so the colors just written remain valid
+	_ledBuffer ^= 1;
+
 	// Start the timeout-timer
 	if (priorityInfo.timeoutTime_ms == -1)
 	{
@@ -8,18 +8,22 @@
 
 using namespace hyperion;
 
-ImageProcessor::ImageProcessor(const LedString& ledString, bool enableBlackBorderDetector, uint8_t blackborderThreshold) :
+ImageProcessor::ImageProcessor(const LedString& ledString, unsigned ledRevision, bool enableBlackBorderDetector, uint8_t blackborderThreshold, unsigned blackborderInterval, MappingEngine mappingEngine, unsigned mappingThreads, unsigned mappingSamples) :
 	_ledString(ledString),
+	_ledRevision(ledRevision),
 	_enableBlackBorderRemoval(enableBlackBorderDetector),
-	_borderProcessor(new BlackBorderProcessor(600, 50, 1, blackborderThreshold)),
-	_imageToLeds(nullptr)
+	_borderProcessor(new BlackBorderProcessor(600, 50, 1, blackborderThreshold, blackborderInterval)),
+	_mappingEngine(mappingEngine),
+	_mappingThreads(mappingThreads),
+	_mappingSamples(mappingSamples),
+	_imageToLeds(),
+	_integralImage()
 {
 	// empty
 }
 
 ImageProcessor::~ImageProcessor()
 {
-	delete _imageToLeds;
 	delete _borderProcessor;
 }
 
@@ -36,11 +40,25 @@ void ImageProcessor::setSize(const unsigned width, const unsigned height)
 		return;
 	}
 
-	// Clean up the old buffer and mapping
-	delete _imageToLeds;
+	// Switch to the (shared) mapping for the new size
+	_imageToLeds = getMap(width, height, 0, 0);
+}
+
+std::shared_ptr<const ImageToLedsMap> ImageProcessor::getMap(const unsigned width, const unsigned height, const unsigned horizontalBorder, const unsigned verticalBorder) const
+{
+	return ImageToLedsMapCache::getInstance().getMap(width, height, horizontalBorder, verticalBorder, _ledString.leds(), _ledRevision, _mappingEngine, _mappingThreads, _mappingSamples);
+}
+
+void ImageProcessor::process(const YuvImage & image, std::vector<ColorRgb> & ledColors)
+{
+	// Ensure that the mapping matches the size of the frame
+	setSize(image.width(), image.height());
+
+	// Check black border detection
+	verifyBorder(image);
 
-	// Construct a new buffer and mapping
-	_imageToLeds = new ImageToLedsMap(width, height, 0, 0, _ledString.leds());
+	// Determine the mean-colors of each led straight from the frame
+	_imageToLeds->getMeanLedColor(image, ledColors);
 }
 
 void ImageProcessor::enableBalckBorderDetector(bool enable)
@@ -48,6 +66,43 @@ void ImageProcessor::enableBalckBorderDetector(bool enable)
 	_enableBlackBorderRemoval = enable;
 }
 
+BlackBorder ImageProcessor::getCurrentBorder() const
+{
+	if (!_enableBlackBorderRemoval)
+	{
+		return BlackBorder({true, -1, -1});
+	}
+	return _borderProcessor->getCurrentBorder();
+}
+
+void ImageProcessor::shiftBorder(int horizontalShift, int verticalShift)
+{
+	_borderProcessor->shiftBorder(horizontalShift, verticalShift);
+
+	if (!_imageToLeds)
+	{
+		return;
+	}
+
+	// Switch to the (shared) mapping for the resized image with the shifted border
+	const int width = int(_imageToLeds->width()) - 2 * verticalShift;
+	const int height = int(_imageToLeds->height()) - 2 * horizontalShift;
+	const BlackBorder border = getCurrentBorder();
+	if (width <= 0 || height <= 0)
+	{
+		// the mapping is created for the next image
+		_imageToLeds.reset();
+	}
+	else if (border.unknown || width <= 2 * border.verticalSize || height <= 2 * border.horizontalSize)
+	{
+		_imageToLeds = getMap(width, height, 0, 0);
+	}
+	else
+	{
+		_imageToLeds = getMap(width, height, border.horizontalSize, border.verticalSize);
+	}
+}
+
 bool ImageProcessor::getScanParameters(size_t led, double &hscanBegin, double &hscanEnd, double &vscanBegin, double &vscanEnd) const
 {
 	if (led < _ledString.leds().size())
@@ -5,6 +5,7 @@
 // Hyperion includes
 #include <hyperion/ImageProcessorFactory.h>
 #include <hyperion/ImageProcessor.h>
+#include <hyperion/ImageToLedsMapCache.h>
 
 ImageProcessorFactory& ImageProcessorFactory::getInstance()
 {
@@ -13,10 +14,15 @@ ImageProcessorFactory& ImageProcessorFactory::getInstance()
 	return instance;
 }
 
-void ImageProcessorFactory::init(const LedString& ledString, bool enableBlackBorderDetector, double blackborderThreshold)
+void ImageProcessorFactory::init(const LedString& ledString, bool enableBlackBorderDetector, double blackborderThreshold, unsigned blackborderInterval, MappingEngine mappingEngine, unsigned mappingThreads, unsigned mappingSamples)
 {
 	_ledString = ledString;
+	++_ledRevision;
 	_enableBlackBorderDetector = enableBlackBorderDetector;
+	_blackborderInterval = blackborderInterval;
+	_mappingEngine = mappingEngine;
+	_mappingThreads = mappingThreads;
+	_mappingSamples = mappingSamples;
 
 	int threshold = int(std::ceil(blackborderThreshold * 255));
 	if (threshold < 0)
@@ -29,9 +35,12 @@ void ImageProcessorFactory::init(const LedString& ledString, bool enableBlackBor
 	{
 		std::cout << "Black border threshold set to " << blackborderThreshold << " (" << int(_blackborderThreshold) << ")" << std::endl;
 	}
+
+	// Drop the unused mappings of the previous led-configuration
+	hyperion::ImageToLedsMapCache::getInstance().clear();
 }
 
 ImageProcessor* ImageProcessorFactory::newImageProcessor() const
 {
-	return new ImageProcessor(_ledString, _enableBlackBorderDetector, _blackborderThreshold);
+	return new ImageProcessor(_ledString, _ledRevision, _enableBlackBorderDetector, _blackborderThreshold, _blackborderInterval, _mappingEngine, _mappingThreads, _mappingSamples);
 }
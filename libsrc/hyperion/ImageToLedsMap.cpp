@@ -3,27 +3,140 @@
 #include <cmath>
 #include <cassert>
 
+// QT includes
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+
 // hyperion includes
 #include <hyperion/ImageToLedsMap.h>
 
 using namespace hyperion;
 
+namespace
+{
+	/// The maximum number of shards in which the leds are processed
+	const unsigned MAX_SHARDS = 16;
+
+	/// The minimum number of pixels for which it is worth to start an additional shard
+	const uint64_t MIN_PIXELS_PER_SHARD = 16384;
+
+	/// The cost of a single led, next to the cost of its pixels
+	const uint64_t LED_COST = 16;
+
+	///
+	/// Runnable which executes the work of a single shard on the worker pool
+	///
+	class ShardRunnable : public QRunnable
+	{
+	public:
+		ShardRunnable() :
+			QRunnable(),
+			_work(nullptr),
+			_shard(0),
+			_finished(nullptr)
+		{
+			setAutoDelete(false);
+		}
+
+		void setup(const std::function<void(unsigned)> * work, unsigned shard, QSemaphore * finished)
+		{
+			_work = work;
+			_shard = shard;
+			_finished = finished;
+		}
+
+		virtual void run()
+		{
+			(*_work)(_shard);
+			_finished->release();
+		}
+
+	private:
+		/// The work to execute
+		const std::function<void(unsigned)> * _work;
+		/// The shard to execute the work for
+		unsigned _shard;
+		/// Semaphore released when the work has finished
+		QSemaphore * _finished;
+	};
+
+	///
+	/// Adds the luma and chroma of the pixels of a span of a yuv frame to the sums
+	///
+	/// @param[in] row  The first byte of the frame row
+	/// @param[in] column  The frame column of the first pixel
+	/// @param[in] columnStep  The number of frame columns between two pixels
+	/// @param[in] count  The number of pixels
+	/// @param[in,out] sums  The sums of the luma (red), u (green) and v (blue)
+	///
+	template <bool UYVY>
+	void sumYuvPixels(const uint8_t * row, unsigned column, const unsigned columnStep, unsigned count, ChannelSums & sums)
+	{
+		const unsigned lumaIndex = UYVY ? 1 : 0;
+		const unsigned uIndex    = UYVY ? 0 : 1;
+		const unsigned vIndex    = UYVY ? 2 : 3;
+
+		uint32_t luma = 0;
+		uint32_t u    = 0;
+		uint32_t v    = 0;
+		for (; count > 0; --count, column += columnStep)
+		{
+			const uint8_t * pair = row + (column & ~1u) * 2;
+			luma += pair[(column & 1) * 2 + lumaIndex];
+			u    += pair[uIndex];
+			v    += pair[vIndex];
+		}
+		sums.red   += luma;
+		sums.green += u;
+		sums.blue  += v;
+	}
+
+	///
+	/// Creates the worker pool. The threads of the pool never expire, so they are reused for every
+	/// frame. The calling thread processes a shard itself, so one core is left for it.
+	///
+	QThreadPool * createWorkerPool()
+	{
+		QThreadPool * pool = new QThreadPool();
+		pool->setExpiryTimeout(-1);
+		pool->setMaxThreadCount(std::max(1, QThread::idealThreadCount() - 1));
+		return pool;
+	}
+
+	///
+	/// Returns the process-wide worker pool
+	///
+	QThreadPool & workerPool()
+	{
+		static QThreadPool * pool = createWorkerPool();
+		return *pool;
+	}
+}
+
 ImageToLedsMap::ImageToLedsMap(
 		const unsigned width,
 		const unsigned height,
 		const unsigned horizontalBorder,
 		const unsigned verticalBorder,
-		const std::vector<Led>& leds) :
+		const std::vector<Led>& leds,
+		const MappingEngine engine,
+		const unsigned threadCount,
+		const unsigned sampleCount) :
 	_width(width),
 	_height(height),
-	mColorsMap()
+	_spans(),
+	_ledRegions(),
+	_shardLeds(),
+	_useIntegralImage(false)
 {
 	// Sanity check of the size of the borders (and width and height)
 	assert(width  > 2*verticalBorder);
 	assert(height > 2*horizontalBorder);
 
 	// Reserve enough space in the map for the leds
-	mColorsMap.reserve(leds.size());
+	_ledRegions.reserve(leds.size());
 
 	const unsigned xOffset = verticalBorder;
 	const unsigned actualWidth  = width  - 2 * verticalBorder;
@@ -35,7 +148,7 @@ ImageToLedsMap::ImageToLedsMap(
 		// skip leds without area
 		if ((led.maxX_frac-led.minX_frac) < 1e-6 || (led.maxY_frac-led.minY_frac) < 1e-6)
 		{
-			mColorsMap.emplace_back();
+			_ledRegions.push_back(LedRegion{unsigned(_spans.size()), 0, 0, 1, 0, 0, 0, 0});
 			continue;
 		}
 
@@ -57,18 +170,97 @@ ImageToLedsMap::ImageToLedsMap(
 			maxY_idx = minY_idx + 1;
 		}
 
-		// Add all the indices in the above defined rectangle to the indices for this led
-		std::vector<unsigned> ledColors;
-		for (unsigned y = minY_idx; y<maxY_idx && y<(yOffset+actualHeight); ++y)
+		// Clip the rectangle to the image (without the borders)
+		maxX_idx = std::min(maxX_idx, xOffset + actualWidth);
+		maxY_idx = std::min(maxY_idx, yOffset + actualHeight);
+
+		LedRegion region{unsigned(_spans.size()), 0, 0, 1, minX_idx, maxX_idx, minY_idx, maxY_idx};
+
+		const unsigned regionWidth  = maxX_idx - minX_idx;
+		const unsigned regionHeight = maxY_idx - minY_idx;
+		if (sampleCount > 0 && engine != MAPPINGENGINE_INTEGRAL && regionWidth * regionHeight > sampleCount)
 		{
-			for (unsigned x = minX_idx; x<maxX_idx && x<(xOffset+actualWidth); ++x)
+			// Sample the rectangle on a stratified grid of at most sampleCount pixels, which follows
+			// the aspect ratio of the rectangle. Each sample is the center of its grid cell.
+			unsigned gridHeight = unsigned(std::round(std::sqrt(double(sampleCount) * regionHeight / regionWidth)));
+			gridHeight = std::max(1u, std::min(gridHeight, regionHeight));
+			const unsigned gridWidth = std::max(1u, std::min(sampleCount / gridHeight, regionWidth));
+			gridHeight = std::max(1u, std::min(sampleCount / gridWidth, regionHeight));
+
+			const unsigned xStep = regionWidth  / gridWidth;
+			const unsigned yStep = regionHeight / gridHeight;
+			const unsigned xBegin = minX_idx + xStep/2;
+			const unsigned xEnd = xBegin + (gridWidth - 1) * xStep + 1;
+
+			region.step = xStep;
+			for (unsigned row = 0; row < gridHeight; ++row)
 			{
-				ledColors.push_back(y*width + x);
+				_spans.push_back(PixelSpan{minY_idx + yStep/2 + row * yStep, xBegin, xEnd});
+				++region.spanCount;
+				region.pixelCount += gridWidth;
+			}
+		}
+		else
+		{
+			// Add a span for each row of the above defined rectangle
+			for (unsigned y = minY_idx; y < maxY_idx; ++y)
+			{
+				_spans.push_back(PixelSpan{y, minX_idx, maxX_idx});
+				++region.spanCount;
+				region.pixelCount += regionWidth;
 			}
 		}
 
-		// Add the constructed vector to the map
-		mColorsMap.push_back(ledColors);
+		// Add the constructed region to the map
+		_ledRegions.push_back(region);
+	}
+
+	switch (engine)
+	{
+	case MAPPINGENGINE_DIRECT:
+		_useIntegralImage = false;
+		break;
+	case MAPPINGENGINE_INTEGRAL:
+		_useIntegralImage = true;
+		break;
+	case MAPPINGENGINE_AUTO:
+	default:
+	{
+		// The integral image costs a fixed pass over the image, summing directly costs a pass over
+		// all (sampled) led regions. Use the integral image when the regions cover more than the image.
+		uint64_t totalPixelCount = 0;
+		for (const LedRegion & region : _ledRegions)
+		{
+			totalPixelCount += region.pixelCount;
+		}
+		_useIntegralImage = totalPixelCount > uint64_t(width) * height;
+		break;
+	}
+	}
+
+	// Split the leds in contiguous shards of (roughly) equal cost
+	uint64_t totalCost = 0;
+	for (const LedRegion & region : _ledRegions)
+	{
+		totalCost += region.pixelCount + LED_COST;
+	}
+
+	unsigned shards = (threadCount == 0) ? unsigned(std::max(1, QThread::idealThreadCount())) : threadCount;
+	shards = std::min(shards, MAX_SHARDS);
+	shards = std::min(shards, unsigned(totalCost / MIN_PIXELS_PER_SHARD));
+	if (shards > 1 && !_useIntegralImage)
+	{
+		_shardLeds.push_back(0);
+		uint64_t cost = 0;
+		for (unsigned led = 0; led < _ledRegions.size(); ++led)
+		{
+			cost += _ledRegions[led].pixelCount + LED_COST;
+			if (cost * shards >= totalCost * _shardLeds.size() && _shardLeds.size() < shards && led + 1 < _ledRegions.size())
+			{
+				_shardLeds.push_back(led + 1);
+			}
+		}
+		_shardLeds.push_back(_ledRegions.size());
 	}
 }
 
@@ -81,3 +273,87 @@ unsigned ImageToLedsMap::height() const
 {
 	return _height;
 }
+
+bool ImageToLedsMap::usesIntegralImage() const
+{
+	return _useIntegralImage;
+}
+
+unsigned ImageToLedsMap::shardCount() const
+{
+	return _shardLeds.empty() ? 1 : _shardLeds.size() - 1;
+}
+
+void ImageToLedsMap::getMeanLedColor(const YuvImage & image, std::vector<ColorRgb> & ledColors) const
+{
+	// Sanity check for the number of leds and the size of the frame
+	assert(_ledRegions.size() == ledColors.size());
+	assert(image.width() == _width && image.height() == _height);
+
+	if (_shardLeds.size() > 2)
+	{
+		// Process the shards on the worker pool
+		runShards([&](unsigned shard){ getMeanLedColor(image, ledColors, _shardLeds[shard], _shardLeds[shard+1]); });
+		return;
+	}
+
+	getMeanLedColor(image, ledColors, 0, _ledRegions.size());
+}
+
+void ImageToLedsMap::getMeanLedColor(const YuvImage & image, std::vector<ColorRgb> & ledColors, unsigned firstLed, unsigned endLed) const
+{
+	const bool uyvy = image.isUyvy();
+	const unsigned columnStep = image.columnStep();
+
+	for (unsigned led = firstLed; led < endLed; ++led)
+	{
+		const LedRegion & region = _ledRegions[led];
+		if (region.pixelCount == 0)
+		{
+			ledColors[led] = ColorRgb::BLACK;
+			continue;
+		}
+
+		// Accumulate the luma and chroma of the (sampled) pixels of the led
+		ChannelSums sums = {0, 0, 0};
+		const PixelSpan * span = _spans.data() + region.firstSpan;
+		const PixelSpan * spanEnd = span + region.spanCount;
+		for (; span != spanEnd; ++span)
+		{
+			const unsigned count = (span->xEnd - span->xBegin + region.step - 1) / region.step;
+			if (uyvy)
+			{
+				sumYuvPixels<true>(image.row(span->row), image.column(span->xBegin), columnStep * region.step, count, sums);
+			}
+			else
+			{
+				sumYuvPixels<false>(image.row(span->row), image.column(span->xBegin), columnStep * region.step, count, sums);
+			}
+		}
+
+		// Convert the (rounded) mean to rgb
+		const unsigned half = region.pixelCount / 2;
+		ledColors[led] = YuvImage::toRgb(
+				(sums.red   + half) / region.pixelCount,
+				(sums.green + half) / region.pixelCount,
+				(sums.blue  + half) / region.pixelCount);
+	}
+}
+
+void ImageToLedsMap::runShards(const std::function<void(unsigned)> & work) const
+{
+	const unsigned shards = shardCount();
+
+	// Hand all but the first shard to the worker pool
+	QSemaphore finished;
+	ShardRunnable runnables[MAX_SHARDS];
+	for (unsigned shard = 1; shard < shards; ++shard)
+	{
+		runnables[shard].setup(&work, shard, &finished);
+		workerPool().start(&runnables[shard]);
+	}
+
+	// Process the first shard on this thread and wait for the others
+	work(0);
+	finished.acquire(shards - 1);
+}
@@ -0,0 +1,93 @@
+
+// QT includes
+#include <QMutexLocker>
+
+// hyperion includes
+#include <hyperion/ImageToLedsMapCache.h>
+
+using namespace hyperion;
+
+bool ImageToLedsMapCache::Key::operator==(const Key & other) const
+{
+	return width == other.width
+			&& height == other.height
+			&& horizontalBorder == other.horizontalBorder
+			&& verticalBorder == other.verticalBorder
+			&& ledRevision == other.ledRevision
+			&& engine == other.engine
+			&& threadCount == other.threadCount
+			&& sampleCount == other.sampleCount;
+}
+
+ImageToLedsMapCache& ImageToLedsMapCache::getInstance()
+{
+	static ImageToLedsMapCache instance(8);
+	// Return the singleton instance
+	return instance;
+}
+
+ImageToLedsMapCache::ImageToLedsMapCache(const unsigned capacity) :
+	_capacity(capacity),
+	_mutex(),
+	_entries()
+{
+	// empty
+}
+
+std::shared_ptr<const ImageToLedsMap> ImageToLedsMapCache::getMap(
+		const unsigned width,
+		const unsigned height,
+		const unsigned horizontalBorder,
+		const unsigned verticalBorder,
+		const std::vector<Led> & leds,
+		const unsigned ledRevision,
+		const MappingEngine engine,
+		const unsigned threadCount,
+		const unsigned sampleCount)
+{
+	const Key key = {width, height, horizontalBorder, verticalBorder, ledRevision, engine, threadCount, sampleCount};
+
+	QMutexLocker lock(&_mutex);
+
+	for (auto entry = _entries.begin(); entry != _entries.end(); ++entry)
+	{
+		if (entry->key == key)
+		{
+			// Move the entry to the front (most recently used)
+			_entries.splice(_entries.begin(), _entries, entry);
+			return _entries.front().map;
+		}
+	}
+
+	// The mapping is built while holding the lock so concurrent requests for the same mapping
+	// wait for it instead of building it twice
+	const std::shared_ptr<const ImageToLedsMap> map = std::make_shared<const ImageToLedsMap>(width, height, horizontalBorder, verticalBorder, leds, engine, threadCount, sampleCount);
+	const Entry entry = {key, map};
+	_entries.push_front(entry);
+
+	evict();
+
+	return map;
+}
+
+void ImageToLedsMapCache::clear()
+{
+	QMutexLocker lock(&_mutex);
+
+	_entries.remove_if([](const Entry & entry){ return entry.map.use_count() == 1; });
+}
+
+void ImageToLedsMapCache::evict()
+{
+	unsigned count = _entries.size();
+	for (auto entry = _entries.end(); count > _capacity && entry != _entries.begin();)
+	{
+		--entry;
+		// Only the cache holds a reference when the mapping is not in use
+		if (entry->map.use_count() == 1)
+		{
+			entry = _entries.erase(entry);
+			--count;
+		}
+	}
+}
@@ -0,0 +1,111 @@
+// STL includes
+#include <iostream>
+
+#include "LedDelayLine.h"
+
+LedDelayLine::LedDelayLine(LedDevice * ledDevice, int delay_ms, unsigned ledCount) :
+	QObject(),
+	LedDevice(),
+	_ledDevice(ledDevice),
+	_delay_ms(delay_ms),
+	_frames(),
+	_first(0),
+	_count(0),
+	_clock(),
+	_timer(),
+	_achievedDelay_ms(-1),
+	_droppedFrames(0)
+{
+	// room for the delay at an input rate up to 200Hz; all frames are allocated up front
+	_frames.resize(delay_ms / 5 + 2);
+	for (Frame & frame : _frames)
+	{
+		frame.time_ms = 0;
+		frame.ledValues.reserve(ledCount);
+	}
+
+	_clock.start();
+	_timer.setSingleShot(true);
+	connect(&_timer, SIGNAL(timeout()), this, SLOT(releaseFrames()));
+}
+
+LedDelayLine::~LedDelayLine()
+{
+	if (_droppedFrames > 0)
+	{
+		std::cout << "LedDelayLine: " << _droppedFrames << " frames dropped because the delay line was full" << std::endl;
+	}
+
+	delete _ledDevice;
+}
+
+int LedDelayLine::write(const std::vector<ColorRgb> & ledValues)
+{
+	if (_count == _frames.size())
+	{
+		// the delay line is full; drop the oldest frame
+		_first = (_first + 1) % _frames.size();
+		--_count;
+		++_droppedFrames;
+	}
+
+	Frame & frame = _frames[(_first + _count) % _frames.size()];
+	frame.time_ms = _clock.elapsed();
+	frame.ledValues.assign(ledValues.begin(), ledValues.end());
+	++_count;
+
+	if (!_timer.isActive())
+	{
+		scheduleRelease();
+	}
+
+	return 0;
+}
+
+int LedDelayLine::switchOff()
+{
+	// discard the delayed frames
+	_timer.stop();
+	_first = 0;
+	_count = 0;
+
+	return _ledDevice->switchOff();
+}
+
+int LedDelayLine::getAchievedDelay() const
+{
+	return _achievedDelay_ms;
+}
+
+void LedDelayLine::releaseFrames()
+{
+	const qint64 now = _clock.elapsed();
+
+	// skip to the newest frame which is due
+	const Frame * dueFrame = nullptr;
+	while (_count > 0 && _frames[_first].time_ms + _delay_ms <= now)
+	{
+		dueFrame = &_frames[_first];
+		_first = (_first + 1) % _frames.size();
+		--_count;
+	}
+
+	if (dueFrame != nullptr)
+	{
+		_achievedDelay_ms = now - dueFrame->time_ms;
+		_ledDevice->write(dueFrame->ledValues);
+	}
+
+	scheduleRelease();
+}
+
+void LedDelayLine::scheduleRelease()
+{
+	if (_count == 0)
+	{
+		return;
+	}
+
+	const qint64 remaining_ms = _frames[_first].time_ms + _delay_ms - _clock.elapsed();
+	_timer.start(remaining_ms > 0 ? int(remaining_ms) : 0);
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+// STL includes
+#include <vector>
+
+// Qt includes
+#include <QTimer>
+#include <QElapsedTimer>
+
+// hyperion includes
+#include <leddevice/LedDevice.h>
+
+/// Delay line for led values
+///
+/// This class delays the led values written to it by a fixed time before forwarding them to the
+/// device, so the leds can be aligned with a picture which is delayed by the processing of the
+/// display. The frames are kept in a preallocated ring with their (monotonic) time stamp and
+/// released by a timer once they are due; when several frames are due only the newest is written.
+/// This class can be handled as a generic LedDevice.
+class LedDelayLine : public QObject, public LedDevice
+{
+	Q_OBJECT
+
+public:
+	/// Constructor
+	/// @param ledDevice The led device (ownership is transferred)
+	/// @param delay_ms The time the led values are delayed (msec)
+	/// @param ledCount The number of leds
+	LedDelayLine(LedDevice * ledDevice, int delay_ms, unsigned ledCount);
+
+	/// Destructor
+	virtual ~LedDelayLine();
+
+	/// Adds the led values to the delay line
+	///
+	/// @param ledValues The color-value per led
+	/// @return Zero on succes else negative
+	///
+	virtual int write(const std::vector<ColorRgb> & ledValues);
+
+	/// Discards the delayed values and switches the leds off immediately
+	virtual int switchOff();
+
+	/// @return The delay of the last frame written to the device (msec, -1 if none was written)
+	int getAchievedDelay() const;
+
+private slots:
+	/// Timer callback which writes the newest due frame to the led device
+	void releaseFrames();
+
+private:
+	/// Starts the timer for the oldest frame in the delay line
+	void scheduleRelease();
+
+private:
+	/// A delayed frame
+	struct Frame
+	{
+		/// The time the frame was written to the delay line (msec)
+		qint64 time_ms;
+		/// The led values of the frame
+		std::vector<ColorRgb> ledValues;
+	};
+
+	/// The led device
+	LedDevice * _ledDevice;
+
+	/// The delay of the led values (msec)
+	const qint64 _delay_ms;
+
+	/// The ring with delayed frames
+	std::vector<Frame> _frames;
+
+	/// The index of the oldest frame in the ring
+	unsigned _first;
+
+	/// The number of frames in the ring
+	unsigned _count;
+
+	/// The monotonic clock for the time stamps
+	QElapsedTimer _clock;
+
+	/// The Qt timer object
+	QTimer _timer;
+
+	/// The delay of the last frame written to the device (msec)
+	int _achievedDelay_ms;
+
+	/// The number of frames dropped because the ring was full
+	unsigned _droppedFrames;
+};
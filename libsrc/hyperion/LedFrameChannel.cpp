@@ -0,0 +1,58 @@
+
+// Qt includes
+#include <QMetaObject>
+
+// Hyperion includes
+#include <hyperion/Hyperion.h>
+#include <hyperion/LedFrameChannel.h>
+
+LedFrameChannel::LedFrameChannel(Hyperion * hyperion, int priority, int timeout_ms) :
+	_hyperion(hyperion),
+	_priority(priority),
+	_timeout_ms(timeout_ms),
+	_ring(std::vector<ColorRgb>(hyperion->getLedCount(), ColorRgb{0,0,0})),
+	_notified(false)
+{
+	_hyperion->registerChannel(this);
+}
+
+LedFrameChannel::~LedFrameChannel()
+{
+	_hyperion->unregisterChannel(this);
+}
+
+int LedFrameChannel::getPriority() const
+{
+	return _priority;
+}
+
+int LedFrameChannel::getTimeout() const
+{
+	return _timeout_ms;
+}
+
+std::vector<ColorRgb> & LedFrameChannel::producerSlot()
+{
+	return _ring.producerSlot();
+}
+
+void LedFrameChannel::publish()
+{
+	_ring.publish();
+	if (!_notified.exchange(true))
+	{
+		QMetaObject::invokeMethod(_hyperion, "consumeChannels", Qt::QueuedConnection);
+	}
+}
+
+bool LedFrameChannel::take()
+{
+	// clear the flag first, so colors published from now on are notified again
+	_notified = false;
+	return _ring.take();
+}
+
+std::vector<ColorRgb> & LedFrameChannel::consumerSlot()
+{
+	return _ring.consumerSlot();
+}
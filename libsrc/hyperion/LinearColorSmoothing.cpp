@@ -1,8 +1,37 @@
+// STL includes
+#include <cstring>
+
 // Qt includes
 #include <QDateTime>
 
 #include "LinearColorSmoothing.h"
 
+namespace
+{
+	///
+	/// Moves each color channel the given fraction of its remaining distance to the target. The
+	/// loop only uses integer arithmetic without branches, so it is vectorised by the compiler.
+	///
+	/// @param current The current color channels (updated in place)
+	/// @param target The target color channels
+	/// @param count The number of color channels
+	/// @param fraction The fraction of the distance to cover (16.16 fixed point, [0; 65536])
+	///
+	/// @return True if any channel changed
+	///
+	bool smoothChannels(uint8_t * current, const uint8_t * target, size_t count, int32_t fraction)
+	{
+		int32_t changed = 0;
+		for (size_t i = 0; i < count; ++i)
+		{
+			const int32_t step = ((target[i] - current[i]) * fraction + 0x8000) >> 16;
+			current[i] = uint8_t(current[i] + step);
+			changed |= step;
+		}
+		return changed != 0;
+	}
+}
+
 LinearColorSmoothing::LinearColorSmoothing(LedDevice *ledDevice, double ledUpdateFrequency_hz, int settlingTime_ms) :
 	QObject(),
 	LedDevice(),
@@ -24,21 +53,28 @@ LinearColorSmoothing::~LinearColorSmoothing()
 
 int LinearColorSmoothing::write(const std::vector<ColorRgb> &ledValues)
 {
+	const int64_t now = QDateTime::currentMSecsSinceEpoch();
+
 	// received a new target color
 	if (_previousValues.size() == 0)
 	{
-		// not initialized yet
-		_targetTime = QDateTime::currentMSecsSinceEpoch() + _settlingTime;
+		// not initialized yet; start at the target
+		_targetTime = now + _settlingTime;
 		_targetValues = ledValues;
 
-		_previousTime = QDateTime::currentMSecsSinceEpoch();
+		_previousTime = now;
 		_previousValues = ledValues;
-		_timer.start();
+		return _ledDevice->write(_previousValues);
 	}
-	else
+
+	_targetTime = now + _settlingTime;
+	memcpy(_targetValues.data(), ledValues.data(), ledValues.size() * sizeof(ColorRgb));
+
+	// (re)start the filter when it was idle
+	if (!_timer.isActive())
 	{
-		_targetTime = QDateTime::currentMSecsSinceEpoch() + _settlingTime;
-		memcpy(_targetValues.data(), ledValues.data(), ledValues.size() * sizeof(ColorRgb));
+		_previousTime = now;
+		_timer.start();
 	}
 
 	return 0;
@@ -61,31 +97,34 @@ int LinearColorSmoothing::switchOff()
 
 void LinearColorSmoothing::updateLeds()
 {
-	int64_t now = QDateTime::currentMSecsSinceEpoch();
-	int deltaTime = _targetTime - now;
+	const int64_t now = QDateTime::currentMSecsSinceEpoch();
+	const int64_t deltaTime = _targetTime - now;
 
-	if (deltaTime < 0)
-	{
-		memcpy(_previousValues.data(), _targetValues.data(), _targetValues.size() * sizeof(ColorRgb));
-		_previousTime = now;
+	uint8_t * previous = reinterpret_cast<uint8_t *>(_previousValues.data());
+	const uint8_t * target = reinterpret_cast<const uint8_t *>(_targetValues.data());
+	const size_t channelCount = _previousValues.size() * sizeof(ColorRgb);
 
-		_ledDevice->write(_previousValues);
+	bool changed;
+	if (deltaTime <= 0)
+	{
+		changed = memcmp(previous, target, channelCount) != 0;
+		memcpy(previous, target, channelCount);
 	}
 	else
 	{
-		float k = 1.0f - 1.0f * deltaTime / (_targetTime - _previousTime);
-
-		for (size_t i = 0; i < _previousValues.size(); ++i)
-		{
-			ColorRgb & prev = _previousValues[i];
-			ColorRgb & target = _targetValues[i];
-
-			prev.red   += k * (target.red   - prev.red);
-			prev.green += k * (target.green - prev.green);
-			prev.blue  += k * (target.blue  - prev.blue);
-		}
-		_previousTime = now;
+		const int32_t fraction = 65536 - int32_t((deltaTime << 16) / (_targetTime - _previousTime));
+		changed = smoothChannels(previous, target, channelCount, fraction);
+	}
+	_previousTime = now;
 
+	if (changed)
+	{
 		_ledDevice->write(_previousValues);
 	}
+
+	// stop the filter until the next write when the target is reached
+	if (memcmp(previous, target, channelCount) == 0)
+	{
+		_timer.stop();
+	}
 }
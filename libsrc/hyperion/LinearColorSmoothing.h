@@ -13,7 +13,8 @@
 /// Linear Smooting class
 ///
 /// This class processes the requested led values and forwards them to the device after applying
-/// a linear smoothing effect. This class can be handled as a generic LedDevice.
+/// a linear smoothing effect. This class can be handled as a generic LedDevice. The update timer
+/// only runs while the led values have not reached their target.
 class LinearColorSmoothing : public QObject, public LedDevice
 {
 	Q_OBJECT
@@ -39,7 +40,8 @@ public:
 	virtual int switchOff();
 
 private slots:
-	/// Timer callback which writes updated led values to the led device
+	/// Timer callback which writes updated led values to the led device and stops the timer when
+	/// the target values are reached
 	void updateLeds();
 
 private:
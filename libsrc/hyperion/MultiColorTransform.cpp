@@ -1,12 +1,15 @@
 
 // STL includes
+#include <algorithm>
 #include <cassert>
 
 // Hyperion includes
 #include "MultiColorTransform.h"
 
 MultiColorTransform::MultiColorTransform(const unsigned ledCnt) :
-	_ledTransforms(ledCnt, nullptr)
+	_ledTransforms(ledCnt, nullptr),
+	_tables(),
+	_ledRuns()
 {
 }
 
@@ -36,6 +39,32 @@ void MultiColorTransform::setTransformForLed(const std::string& id, const unsign
 	{
 		_ledTransforms[iLed] = transform;
 	}
+
+	updateLedRuns();
+}
+
+void MultiColorTransform::updateLedRuns()
+{
+	_ledRuns.clear();
+	for (unsigned iLed=0; iLed<_ledTransforms.size(); ++iLed)
+	{
+		ColorTransform * transform = _ledTransforms[iLed];
+		if (transform == nullptr)
+		{
+			// No transform set for this led (not part of any run)
+			continue;
+		}
+
+		if (!_ledRuns.empty() && _ledRuns.back().end == iLed && _transform[_ledRuns.back().transform] == transform)
+		{
+			// Extend the current run
+			++_ledRuns.back().end;
+			continue;
+		}
+
+		const unsigned index = std::find(_transform.begin(), _transform.end(), transform) - _transform.begin();
+		_ledRuns.push_back(LedRun{iLed, iLed+1, index});
+	}
 }
 
 bool MultiColorTransform::verifyTransforms() const
@@ -72,26 +101,27 @@ ColorTransform* MultiColorTransform::getTransform(const std::string& id)
 	return nullptr;
 }
 
-std::vector<ColorRgb> MultiColorTransform::applyTransform(const std::vector<ColorRgb>& rawColors)
+void MultiColorTransform::updateTransforms()
+{
+	_tables.resize(_transform.size());
+	for (size_t i=0; i<_transform.size(); ++i)
+	{
+		_tables[i].compile(*_transform[i]);
+	}
+}
+
+void MultiColorTransform::applyTransform(const std::vector<ColorRgb>& rawColors, std::vector<ColorRgb>& ledColors)
 {
-	// Create a copy, as we will do the rest of the transformation in place
-	std::vector<ColorRgb> ledColors(rawColors);
+	// Copy into the output (reusing its memory), as we will do the rest of the transformation in place
+	ledColors.assign(rawColors.begin(), rawColors.end());
 
-	const size_t itCnt = std::min(_ledTransforms.size(), rawColors.size());
-	for (size_t i=0; i<itCnt; ++i)
+	const unsigned ledCnt = ledColors.size();
+	for (const LedRun & run : _ledRuns)
 	{
-		ColorTransform* transform = _ledTransforms[i];
-		if (transform == nullptr)
+		if (run.begin >= ledCnt)
 		{
-			// No transform set for this led (do nothing)
-			continue;
+			break;
 		}
-		ColorRgb& color = ledColors[i];
-
-		transform->_hsvTransform.transform(color.red, color.green, color.blue);
-		color.red   = transform->_rgbRedTransform.transform(color.red);
-		color.green = transform->_rgbGreenTransform.transform(color.green);
-		color.blue  = transform->_rgbBlueTransform.transform(color.blue);
+		_tables[run.transform].transform(&ledColors[run.begin], std::min(run.end, ledCnt) - run.begin);
 	}
-	return ledColors;
 }
@@ -8,6 +8,7 @@
 
 // Hyperion includes
 #include <hyperion/ColorTransform.h>
+#include "ColorTransformTable.h"
 
 ///
 /// The LedColorTransform is responsible for performing color transformation from 'raw' colors
@@ -46,13 +47,20 @@ public:
 	ColorTransform* getTransform(const std::string& id);
 
 	///
-	/// Performs the color transoformation from raw-color to led-color
+	/// Compiles the ColorTransforms into their lookup tables. Must be called after the transforms
+	/// have been set up and every time the parameters of a ColorTransform have been changed.
 	///
-	/// @param rawColors The list with raw colors
+	void updateTransforms();
+
 	///
-	/// @return The list with led-colors
+	/// Performs the color transoformation from raw-color to led-color. The led-colors are written
+	/// into the given list, which does not allocate when it already has the capacity for all leds.
+	/// The transforms are applied per run of leds with the same ColorTransform.
 	///
-	std::vector<ColorRgb> applyTransform(const std::vector<ColorRgb>& rawColors);
+	/// @param rawColors The list with raw colors
+	/// @param ledColors The list with led-colors
+	///
+	void applyTransform(const std::vector<ColorRgb>& rawColors, std::vector<ColorRgb>& ledColors);
 
 private:
 	/// List with transform ids
@@ -63,4 +71,27 @@ private:
 
 	/// List with a pointer to the ColorTransform for each individual led
 	std::vector<ColorTransform*> _ledTransforms;
+
+	/// List with the compiled table of each unique ColorTransform
+	std::vector<ColorTransformTable> _tables;
+
+	/// A run of consecutive leds which use the same ColorTransform
+	struct LedRun
+	{
+		/// The first led of the run
+		unsigned begin;
+		/// The led after the last led of the run
+		unsigned end;
+		/// The index of the ColorTransform (and its table)
+		unsigned transform;
+	};
+
+	/// List with the runs of leds with a ColorTransform (ordered by led, leds without a
+	/// ColorTransform are not part of any run)
+	std::vector<LedRun> _ledRuns;
+
+	///
+	/// Regroups the leds into runs with the same ColorTransform
+	///
+	void updateLedRuns();
 };
@@ -9,6 +9,8 @@
 PriorityMuxer::PriorityMuxer(int ledCount) :
 	_currentPriority(LOWEST_PRIORITY),
 	_activeInputs(),
+	_timeouts(),
+	_queuedTimeouts(),
 	_lowestPriorityInfo()
 {
 	_lowestPriorityInfo.priority = LOWEST_PRIORITY;
@@ -52,13 +54,28 @@ const PriorityMuxer::InputInfo& PriorityMuxer::getInputInfo(const int priority)
 }
 
 void PriorityMuxer::setInput(const int priority, const std::vector<ColorRgb>& ledColors, const int64_t timeoutTime_ms)
+{
+	// assign, so the buffer of the channel is reused
+	updateInput(priority, timeoutTime_ms).ledColors = ledColors;
+}
+
+void PriorityMuxer::setInput(const int priority, std::vector<ColorRgb>&& ledColors, const int64_t timeoutTime_ms)
+{
+	updateInput(priority, timeoutTime_ms).ledColors.swap(ledColors);
+}
+
+PriorityMuxer::InputInfo & PriorityMuxer::updateInput(const int priority, const int64_t timeoutTime_ms)
 {
 	InputInfo& input = _activeInputs[priority];
+	if (timeoutTime_ms != -1)
+	{
+		queueTimeout(priority, timeoutTime_ms);
+	}
 	input.priority       = priority;
 	input.timeoutTime_ms = timeoutTime_ms;
-	input.ledColors      = ledColors;
 
 	_currentPriority = std::min(_currentPriority, priority);
+	return input;
 }
 
 void PriorityMuxer::clearInput(const int priority)
@@ -66,38 +83,71 @@ void PriorityMuxer::clearInput(const int priority)
 	_activeInputs.remove(priority);
 	if (_currentPriority == priority)
 	{
-		if (_activeInputs.empty())
-		{
-			_currentPriority = LOWEST_PRIORITY;
-		}
-		else
-		{
-			QList<int> keys = _activeInputs.keys();
-			_currentPriority = *std::min_element(keys.begin(), keys.end());
-		}
+		updateCurrentPriority();
 	}
 }
 
 void PriorityMuxer::clearAll()
 {
 	_activeInputs.clear();
+	_timeouts = decltype(_timeouts)();
+	_queuedTimeouts.clear();
 	_currentPriority = LOWEST_PRIORITY;
 }
 
 void PriorityMuxer::setCurrentTime(const int64_t& now)
 {
-	_currentPriority = LOWEST_PRIORITY;
-
-	for (auto infoIt = _activeInputs.begin(); infoIt != _activeInputs.end();)
+	while (!_timeouts.empty() && _timeouts.top().first <= now)
 	{
-		if (infoIt->timeoutTime_ms != -1 && infoIt->timeoutTime_ms <= now)
+		const Timeout timeout = _timeouts.top();
+		_timeouts.pop();
+
+		auto queuedIt = _queuedTimeouts.find(timeout.second);
+		if (queuedIt != _queuedTimeouts.end() && queuedIt->second == timeout.first)
 		{
-			infoIt = _activeInputs.erase(infoIt);
+			_queuedTimeouts.erase(queuedIt);
 		}
-		else
+
+		auto infoIt = _activeInputs.find(timeout.second);
+		if (infoIt == _activeInputs.end())
 		{
-			_currentPriority = std::min(_currentPriority, infoIt->priority);
-			++infoIt;
+			continue;
+		}
+
+		if (infoIt->timeoutTime_ms == timeout.first)
+		{
+			// the channel was not updated with another timeout in the meantime
+			_activeInputs.erase(infoIt);
+			if (_currentPriority == timeout.second)
+			{
+				updateCurrentPriority();
+			}
+		}
+		else if (infoIt->timeoutTime_ms != -1)
+		{
+			// the channel was updated with a later timeout which was not queued yet
+			queueTimeout(timeout.second, infoIt->timeoutTime_ms);
 		}
 	}
 }
+
+void PriorityMuxer::queueTimeout(const int priority, const int64_t timeoutTime_ms)
+{
+	// a later timeout is queued when the earlier entry expires
+	auto queuedIt = _queuedTimeouts.find(priority);
+	if (queuedIt == _queuedTimeouts.end())
+	{
+		_queuedTimeouts.insert(std::make_pair(priority, timeoutTime_ms));
+		_timeouts.push(Timeout(timeoutTime_ms, priority));
+	}
+	else if (timeoutTime_ms < queuedIt->second)
+	{
+		queuedIt->second = timeoutTime_ms;
+		_timeouts.push(Timeout(timeoutTime_ms, priority));
+	}
+}
+
+void PriorityMuxer::updateCurrentPriority()
+{
+	_currentPriority = _activeInputs.empty() ? LOWEST_PRIORITY : _activeInputs.firstKey();
+}
@@ -16,6 +16,7 @@
 #include <hyperion/ImageProcessor.h>
 #include <hyperion/ColorTransform.h>
 #include <utils/ColorRgb.h>
+#include <utils/ImageView.h>
 
 // project includes
 #include "JsonClientConnection.h"
@@ -140,7 +141,7 @@ void JsonClientConnection::handleColorCommand(const Json::Value &message)
 	}
 
 	// set output
-	_hyperion->setColors(priority, colorData, duration);
+	_hyperion->setColors(priority, std::move(colorData), duration);
 
 	// send reply
 	sendSuccessReply();
@@ -165,13 +166,12 @@ void JsonClientConnection::handleImageCommand(const Json::Value &message)
 	// set width and height of the image processor
 	_imageProcessor->setSize(width, height);
 
-	// create ImageRgb
-	Image<ColorRgb> image(width, height);
-	memcpy(image.memptr(), data.data(), data.size());
+	// view the decoded image data
+	const ImageView<ColorRgb> image(reinterpret_cast<const ColorRgb *>(data.constData()), width, height);
 
 	// process the image
 	std::vector<ColorRgb> ledColors = _imageProcessor->process(image);
-	_hyperion->setColors(priority, ledColors, duration);
+	_hyperion->setColors(priority, std::move(ledColors), duration);
 
 	// send reply
 	sendSuccessReply();
@@ -220,6 +220,13 @@ void JsonClientConnection::handleServerInfoCommand(const Json::Value &)
 		}
 	}
 
+	// report the delay achieved by the latency compensation (if configured)
+	const int delay_ms = _hyperion->getAchievedDelay();
+	if (delay_ms >= 0)
+	{
+		info["delay_ms"] = delay_ms;
+	}
+
 	// collect transform information
 	Json::Value & transformArray = info["transform"];
 	for (const std::string& transformId : _hyperion->getTransformIds())
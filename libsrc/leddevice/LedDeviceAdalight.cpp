@@ -14,7 +14,7 @@
 LedDeviceAdalight::LedDeviceAdalight(const std::string& outputDevice, const unsigned baudrate, int delayAfterConnect_ms) :
 	LedRs232Device(outputDevice, baudrate, delayAfterConnect_ms),
 	_ledBuffer(0),
-	_timer()
+	_timer(this)
 {
 	// setup the timer
 	_timer.setSingleShot(false);
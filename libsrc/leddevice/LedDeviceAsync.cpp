@@ -0,0 +1,113 @@
+
+// STL includes
+#include <iostream>
+
+// Qt includes
+#include <QMutexLocker>
+
+// Local Leddevice includes
+#include "LedDeviceAsync.h"
+
+LedDeviceAsync::LedDeviceAsync(LedDevice * ledDevice) :
+	QObject(),
+	LedDevice(),
+	_ledDevice(ledDevice),
+	_thread(),
+	_mutex(),
+	_command(NONE),
+	_pendingValues(),
+	_writeValues(),
+	_droppedWrites(0),
+	_lastResult(0)
+{
+	// the decorated device lives in the writer thread (if it is a QObject)
+	QObject * deviceObject = dynamic_cast<QObject *>(_ledDevice);
+	if (deviceObject != nullptr)
+	{
+		deviceObject->moveToThread(&_thread);
+	}
+
+	// the mailbox is emptied by the event loop of the writer thread
+	moveToThread(&_thread);
+	_thread.start();
+}
+
+LedDeviceAsync::~LedDeviceAsync()
+{
+	// perform the last command (typically the switch off) before stopping the thread
+	QMetaObject::invokeMethod(this, "writePending", Qt::BlockingQueuedConnection);
+
+	_thread.quit();
+	_thread.wait();
+
+	if (_droppedWrites > 0)
+	{
+		std::cout << "LedDeviceAsync: " << _droppedWrites << " writes dropped by a slow device" << std::endl;
+	}
+
+	delete _ledDevice;
+}
+
+int LedDeviceAsync::write(const std::vector<ColorRgb> & ledValues)
+{
+	QMutexLocker lock(&_mutex);
+	_pendingValues.assign(ledValues.begin(), ledValues.end());
+	post(WRITE);
+	return _lastResult;
+}
+
+int LedDeviceAsync::switchOff()
+{
+	QMutexLocker lock(&_mutex);
+	post(SWITCH_OFF);
+	return _lastResult;
+}
+
+void LedDeviceAsync::post(int command)
+{
+	const bool idle = _command == NONE;
+	if (_command == WRITE)
+	{
+		++_droppedWrites;
+	}
+	_command = command;
+
+	if (idle)
+	{
+		QMetaObject::invokeMethod(this, "writePending", Qt::QueuedConnection);
+	}
+}
+
+void LedDeviceAsync::writePending()
+{
+	int command;
+	{
+		QMutexLocker lock(&_mutex);
+		command = _command;
+		_command = NONE;
+
+		// swap, so both buffers keep their memory
+		_writeValues.swap(_pendingValues);
+	}
+
+	int result;
+	switch (command)
+	{
+	case WRITE:
+		result = _ledDevice->write(_writeValues);
+		break;
+	case SWITCH_OFF:
+		result = _ledDevice->switchOff();
+		break;
+	default:
+		return;
+	}
+
+	// the result is returned by the next write (or switch off) of the caller
+	QMutexLocker lock(&_mutex);
+	if (result < 0 && _lastResult >= 0)
+	{
+		std::cerr << "LedDeviceAsync: the led device failed with " << result << std::endl;
+	}
+	_lastResult = result;
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+// STL includes
+#include <vector>
+
+// Qt includes
+#include <QObject>
+#include <QThread>
+#include <QMutex>
+
+// Leddevice includes
+#include <leddevice/LedDevice.h>
+
+///
+/// Decorator which writes to a LedDevice from a dedicated writer thread. The led values are handed
+/// over through a single-slot mailbox: a new write replaces a write which has not been started
+/// yet, so a slow device drops intermediate frames instead of blocking the caller. When the
+/// decorated device is a QObject it is moved to the writer thread (which runs an event loop), so
+/// its timers and signals are handled there.
+///
+class LedDeviceAsync : public QObject, public LedDevice
+{
+	Q_OBJECT
+
+public:
+	///
+	/// Constructs the decorator and starts the writer thread
+	///
+	/// @param ledDevice The decorated led device (ownership is transferred)
+	///
+	LedDeviceAsync(LedDevice * ledDevice);
+
+	///
+	/// Destructor; performs the pending write (if any), stops the writer thread and deletes the
+	/// decorated device
+	///
+	virtual ~LedDeviceAsync();
+
+	///
+	/// Posts the led values to the writer thread. The write is performed later, so the result of
+	/// the last write (or switch off) performed by the decorated device is returned.
+	///
+	/// @param ledValues The color-value per led
+	/// @return Zero on succes else negative
+	///
+	virtual int write(const std::vector<ColorRgb> & ledValues);
+
+	///
+	/// Posts the switch off to the writer thread
+	///
+	/// @return The result of the last write (or switch off) performed by the decorated device
+	///
+	virtual int switchOff();
+
+private slots:
+	/// Performs the pending command of the mailbox on the decorated device (writer thread)
+	void writePending();
+
+private:
+	///
+	/// Puts a command in the mailbox and wakes the writer thread when it is idle. Must be called
+	/// with the mailbox locked.
+	///
+	void post(int command);
+
+private:
+	/// Enumeration of the commands in the mailbox
+	enum Command
+	{
+		NONE, WRITE, SWITCH_OFF
+	};
+
+	/// The decorated led device
+	LedDevice * _ledDevice;
+
+	/// The writer thread
+	QThread _thread;
+
+	/// Mutex protecting the mailbox
+	QMutex _mutex;
+
+	/// The pending command of the mailbox
+	int _command;
+
+	/// The led values of a pending write
+	std::vector<ColorRgb> _pendingValues;
+
+	/// The led values written by the writer thread (swapped with the pending values)
+	std::vector<ColorRgb> _writeValues;
+
+	/// The number of writes which were replaced before the writer thread performed them
+	unsigned _droppedWrites;
+
+	/// The result of the last command performed by the decorated device (zero on success)
+	int _lastResult;
+};
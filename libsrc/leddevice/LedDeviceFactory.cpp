@@ -29,6 +29,7 @@
 #include "LedDeviceTest.h"
 #include "LedDeviceHyperionUsbasp.h"
 #include "LedDevicePhilipsHue.h"
+#include "LedDeviceAsync.h"
 
 LedDevice * LedDeviceFactory::construct(const Json::Value & deviceConfig)
 {
@@ -176,5 +177,11 @@ LedDevice * LedDeviceFactory::construct(const Json::Value & deviceConfig)
 		std::cout << "Unable to create device " << type << std::endl;
 		// Unknown / Unimplemented device
 	}
+
+	if (device != nullptr && deviceConfig.get("writeThread", false).asBool())
+	{
+		// write from a dedicated thread, so a slow device does not block the caller
+		device = new LedDeviceAsync(device);
+	}
 	return device;
 }
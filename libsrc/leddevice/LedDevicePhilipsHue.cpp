@@ -11,8 +11,7 @@
 #include <QEventLoop>
 
 LedDevicePhilipsHue::LedDevicePhilipsHue(const std::string& output) :
-		host(output.c_str()), username("newdeveloper") {
-	http = new QHttp(host);
+		host(output.c_str()), username("newdeveloper"), http(nullptr) {
 }
 
 LedDevicePhilipsHue::~LedDevicePhilipsHue() {
@@ -55,7 +54,7 @@ void LedDevicePhilipsHue::put(QString route, QString content) {
 	header.setValue("Host", host);
 	header.setValue("Accept-Encoding", "identity");
 	header.setValue("Content-Length", QString("%1").arg(content.size()));
-	http->setHost(host);
+	getHttp()->setHost(host);
 	http->request(header, content.toAscii());
 }
 
@@ -64,7 +63,7 @@ QByteArray LedDevicePhilipsHue::get(QString route) {
 	// Event loop to block until request finished.
 	QEventLoop loop;
 	// Connect requestFinished signal to quit slot of the loop.
-	loop.connect(http, SIGNAL(requestFinished(int, bool)), SLOT(quit()));
+	loop.connect(getHttp(), SIGNAL(requestFinished(int, bool)), SLOT(quit()));
 	// Perfrom request
 	http->get(url);
 	// Go into the loop until the request is finished.
@@ -73,6 +72,14 @@ QByteArray LedDevicePhilipsHue::get(QString route) {
 	return http->readAll();
 }
 
+QHttp * LedDevicePhilipsHue::getHttp() {
+	// Created on first use, so it lives in the thread which writes to the device.
+	if (http == nullptr) {
+		http = new QHttp(host);
+	}
+	return http;
+}
+
 QString LedDevicePhilipsHue::getStateRoute(unsigned int lightId) {
 	return QString("lights/%1/state").arg(lightId);
 }
@@ -53,9 +53,14 @@ private:
 	QString host;
 	/// User name for the API ("newdeveloper")
 	QString username;
-	/// Qhttp object for sending requests.
+	/// Qhttp object for sending requests (created on first use).
 	QHttp* http;
 
+	///
+	/// @return the QHttp object, which is created on first use
+	///
+	QHttp * getHttp();
+
 	///
 	/// Sends a HTTP GET request (blocking).
 	///
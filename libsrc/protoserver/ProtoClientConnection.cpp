@@ -6,6 +6,7 @@
 #include <iostream>
 #include <sstream>
 #include <iterator>
+#include <algorithm>
 
 // Qt includes
 #include <QRgb>
@@ -25,7 +26,11 @@ ProtoClientConnection::ProtoClientConnection(QTcpSocket *socket, Hyperion * hype
 	_socket(socket),
 	_imageProcessor(ImageProcessorFactory::getInstance().newImageProcessor()),
 	_hyperion(hyperion),
-	_receiveBuffer()
+	_receiveBuffer(),
+	_readPosition(0),
+	_request(),
+	_ledColors(),
+	_sendBuffer()
 {
 	// connect internal signals and slots
 	connect(_socket, SIGNAL(disconnected()), this, SLOT(socketClosed()));
@@ -39,39 +44,56 @@ ProtoClientConnection::~ProtoClientConnection()
 
 void ProtoClientConnection::readData()
 {
-	_receiveBuffer += _socket->readAll();
-
-	// check if we can read a message size
-	if (_receiveBuffer.size() <= 4)
+	// append the available data to the receive buffer (which keeps its memory)
+	const qint64 bytesAvailable = _socket->bytesAvailable();
+	if (bytesAvailable > 0)
 	{
-		return;
+		const size_t size = _receiveBuffer.size();
+		_receiveBuffer.resize(size + bytesAvailable);
+		const qint64 bytesRead = _socket->read(_receiveBuffer.data() + size, bytesAvailable);
+		_receiveBuffer.resize(size + std::max(qint64(0), bytesRead));
 	}
 
-	// read the message size
-	uint32_t messageSize =
-			((_receiveBuffer[0]<<24) & 0xFF000000) |
-			((_receiveBuffer[1]<<16) & 0x00FF0000) |
-			((_receiveBuffer[2]<< 8) & 0x0000FF00) |
-			((_receiveBuffer[3]    ) & 0x000000FF);
-
-	// check if we can read a complete message
-	if ((uint32_t) _receiveBuffer.size() < messageSize + 4)
+	// handle all complete messages
+	while (_receiveBuffer.size() - _readPosition >= 4)
 	{
-		return;
+		const uint8_t * data = reinterpret_cast<const uint8_t *>(_receiveBuffer.data() + _readPosition);
+		const size_t bytesBuffered = _receiveBuffer.size() - _readPosition - 4;
+
+		// read the message size
+		const uint32_t messageSize = (uint32_t(data[0]) << 24) | (uint32_t(data[1]) << 16) | (uint32_t(data[2]) << 8) | uint32_t(data[3]);
+
+		// check if we can read a complete message
+		if (bytesBuffered < messageSize)
+		{
+			break;
+		}
+
+		// parse the message straight from the receive buffer
+		if (_request.ParseFromArray(data + 4, messageSize))
+		{
+			handleMessage(_request);
+		}
+		else
+		{
+			sendErrorReply("Unable to parse message");
+		}
+
+		_readPosition += messageSize + 4;
 	}
 
-	// read a message
-	proto::HyperionRequest message;
-	if (!message.ParseFromArray(_receiveBuffer.data() + 4, messageSize))
+	// compact the buffer: rewind when all data is handled, otherwise move the incomplete message to
+	// the front once the handled data takes up more than half of the buffer
+	if (_readPosition == _receiveBuffer.size())
 	{
-		sendErrorReply("Unable to parse message");
+		_receiveBuffer.clear();
+		_readPosition = 0;
+	}
+	else if (_readPosition > _receiveBuffer.size() / 2)
+	{
+		_receiveBuffer.erase(_receiveBuffer.begin(), _receiveBuffer.begin() + _readPosition);
+		_readPosition = 0;
 	}
-
-	// handle the message
-	handleMessage(message);
-
-	// remove message data from buffer
-	_receiveBuffer = _receiveBuffer.mid(messageSize + 4);
 }
 
 void ProtoClientConnection::socketClosed()
@@ -151,13 +173,13 @@ void ProtoClientConnection::handleImageCommand(const proto::ImageRequest &messag
 	// set width and height of the image processor
 	_imageProcessor->setSize(width, height);
 
-	// create ImageRgb
-	Image<ColorRgb> image(width, height);
-	memcpy(image.memptr(), imageData.c_str(), imageData.size());
+	// view the image data where it was received
+	const ImageView<ColorRgb> image(reinterpret_cast<const ColorRgb *>(imageData.data()), width, height);
 
-	// process the image
-	std::vector<ColorRgb> ledColors = _imageProcessor->process(image);
-	_hyperion->setColors(priority, ledColors, duration);
+	// process the image into the colors handed back by the previous image
+	_ledColors.resize(_imageProcessor->getLedCount());
+	_imageProcessor->process(image, _ledColors);
+	_hyperion->setColors(priority, std::move(_ledColors), duration);
 
 	// send reply
 	sendSuccessReply();
@@ -193,11 +215,16 @@ void ProtoClientConnection::handleNotImplemented()
 
 void ProtoClientConnection::sendMessage(const google::protobuf::Message &message)
 {
-	std::string serializedReply = message.SerializeAsString();
-	uint32_t size = serializedReply.size();
-	uint8_t sizeData[] = {uint8_t(size >> 24), uint8_t(size >> 16), uint8_t(size >> 8), uint8_t(size)};
-	_socket->write((const char *) sizeData, sizeof(sizeData));
-	_socket->write(serializedReply.data(), serializedReply.length());
+	// serialize the size and the message into the send buffer
+	const uint32_t size = message.ByteSize();
+	_sendBuffer.resize(size + 4);
+	_sendBuffer[0] = uint8_t(size >> 24);
+	_sendBuffer[1] = uint8_t(size >> 16);
+	_sendBuffer[2] = uint8_t(size >>  8);
+	_sendBuffer[3] = uint8_t(size);
+	message.SerializeWithCachedSizesToArray(_sendBuffer.data() + 4);
+
+	_socket->write((const char *) _sendBuffer.data(), _sendBuffer.size());
 	_socket->flush();
 }
 
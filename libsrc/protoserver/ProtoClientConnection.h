@@ -2,6 +2,7 @@
 
 // stl includes
 #include <string>
+#include <vector>
 
 // Qt includes
 #include <QByteArray>
@@ -10,6 +11,10 @@
 // Hyperion includes
 #include <hyperion/Hyperion.h>
 
+// Utils includes
+#include <utils/ImageView.h>
+#include <utils/ColorRgb.h>
+
 // proto includes
 #include "message.pb.h"
 
@@ -44,7 +49,7 @@ signals:
 
 private slots:
 	///
-	/// Slot called when new data has arrived
+	/// Slot called when new data has arrived. Handles all complete messages in the receive buffer.
 	///
 	void readData();
 
@@ -121,6 +126,19 @@ private:
 	/// Link to Hyperion for writing led-values to a priority channel
 	Hyperion * _hyperion;
 
-	/// The buffer used for reading data from the socket
-	QByteArray _receiveBuffer;
+	/// The buffer used for reading data from the socket (reused for all messages)
+	std::vector<char> _receiveBuffer;
+
+	/// The position in the receive buffer of the first message which is not yet handled
+	size_t _readPosition;
+
+	/// The request into which the received messages are parsed (reused, so the memory of the
+	/// fields, including the image data, is kept between messages)
+	proto::HyperionRequest _request;
+
+	/// The led colors computed from the images (the buffer is exchanged with the priority channel)
+	std::vector<ColorRgb> _ledColors;
+
+	/// The buffer into which the size and the serialized reply are written (reused for all replies)
+	std::vector<uint8_t> _sendBuffer;
 };
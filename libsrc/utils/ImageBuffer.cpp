@@ -0,0 +1,124 @@
+
+// STL includes
+#include <mutex>
+#include <new>
+#include <vector>
+
+// Utils includes
+#include <utils/ImageBuffer.h>
+
+namespace
+{
+	/// The capacity of the smallest size class [bytes]
+	const size_t MIN_CAPACITY = 64;
+
+	/// The number of size classes (four per power of two)
+	const size_t CLASS_COUNT = 4 * 64;
+
+	/// The maximum number of free buffers kept per size class
+	const size_t MAX_FREE_BUFFERS = 4;
+
+	///
+	/// Determines the size class of the given size. Between two powers of two there are four
+	/// classes, so at most a quarter of a buffer is unused.
+	///
+	/// @param size The required capacity [bytes]
+	/// @param capacity The capacity of the size class [bytes]
+	///
+	/// @return The index of the size class
+	///
+	size_t sizeClass(size_t size, size_t & capacity)
+	{
+		if (size <= MIN_CAPACITY)
+		{
+			capacity = MIN_CAPACITY;
+			return 0;
+		}
+
+		size_t base = MIN_CAPACITY;
+		size_t index = 0;
+		while (size > 2 * base)
+		{
+			base *= 2;
+			index += 4;
+		}
+
+		const size_t step = base / 4;
+		const size_t steps = (size - base + step - 1) / step;
+		capacity = base + steps * step;
+		return index + steps;
+	}
+
+	/// The free buffers per size class
+	struct Pool
+	{
+		std::mutex mutex;
+		std::vector<void *> freeBuffers[CLASS_COUNT];
+	};
+
+	Pool & pool()
+	{
+		// never destroyed, as images may still be released during static destruction
+		static Pool * pool = new Pool();
+		return *pool;
+	}
+}
+
+ImageBuffer::ImageBuffer(size_t capacity, size_t sizeClass) :
+	_refs(1),
+	_capacity(capacity),
+	_sizeClass(sizeClass)
+{
+	// empty
+}
+
+ImageBuffer * ImageBuffer::acquire(size_t size)
+{
+	size_t capacity;
+	const size_t index = sizeClass(size, capacity);
+
+	void * memory = nullptr;
+	{
+		Pool & buffers = pool();
+		std::lock_guard<std::mutex> lock(buffers.mutex);
+		std::vector<void *> & freeBuffers = buffers.freeBuffers[index];
+		if (!freeBuffers.empty())
+		{
+			memory = freeBuffers.back();
+			freeBuffers.pop_back();
+		}
+	}
+
+	if (memory == nullptr)
+	{
+		memory = ::operator new(headerSize() + capacity);
+	}
+	return new (memory) ImageBuffer(capacity, index);
+}
+
+void ImageBuffer::release()
+{
+	if (_refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+	{
+		return;
+	}
+
+	const size_t index = _sizeClass;
+	void * memory = this;
+	this->~ImageBuffer();
+
+	{
+		Pool & buffers = pool();
+		std::lock_guard<std::mutex> lock(buffers.mutex);
+		std::vector<void *> & freeBuffers = buffers.freeBuffers[index];
+		if (freeBuffers.size() < MAX_FREE_BUFFERS)
+		{
+			// reserve the complete list at once, so returning buffers does not allocate
+			freeBuffers.reserve(MAX_FREE_BUFFERS);
+			freeBuffers.push_back(memory);
+			return;
+		}
+	}
+
+	::operator delete(memory);
+}
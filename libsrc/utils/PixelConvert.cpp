@@ -0,0 +1,260 @@
+
+// SIMD includes
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define PIXELCONVERT_NEON
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define PIXELCONVERT_SSE2
+#endif
+
+// Utils includes
+#include <utils/PixelConvert.h>
+
+namespace
+{
+	///
+	/// The coefficient tables of the yuv to rgb conversion (video range, BT.601)
+	///
+	/// @see http://en.wikipedia.org/wiki/YUV#Y.27UV444_to_RGB888_conversion
+	///
+	struct YuvTables
+	{
+		YuvTables()
+		{
+			for (int i = 0; i < 256; ++i)
+			{
+				luma[i]   = 298 * (i - 16) + 128;
+				redV[i]   = 409 * (i - 128);
+				greenU[i] = -100 * (i - 128);
+				greenV[i] = -208 * (i - 128);
+				blueU[i]  = 516 * (i - 128);
+			}
+		}
+
+		/// The scaled luma, including the rounding offset
+		int luma[256];
+		/// The contribution of V to red
+		int redV[256];
+		/// The contribution of U to green
+		int greenU[256];
+		/// The contribution of V to green
+		int greenV[256];
+		/// The contribution of U to blue
+		int blueU[256];
+	};
+
+	const YuvTables yuvTables;
+
+	inline uint8_t clamp(int x)
+	{
+		return (x<0) ? 0 : ((x>255) ? 255 : uint8_t(x));
+	}
+
+	/// The byte offsets of the luma and chroma of a pixel pair for each layout
+	template <PixelLayout Layout_T> struct YuvOffsets;
+	template <> struct YuvOffsets<PIXELLAYOUT_YUYV> { enum { luma = 0, u = 1, v = 3 }; };
+	template <> struct YuvOffsets<PIXELLAYOUT_UYVY> { enum { luma = 1, u = 0, v = 2 }; };
+
+	///
+	/// Converts a single pixel of a packed yuv 4:2:2 row using the coefficient tables
+	///
+	template <PixelLayout Layout_T>
+	inline void convertYuvPixel(const uint8_t * row, unsigned column, ColorRgb & rgb)
+	{
+		const uint8_t * pair = row + (column & ~1u) * 2;
+		const int luma = yuvTables.luma[pair[(column & 1) * 2 + YuvOffsets<Layout_T>::luma]];
+		const uint8_t u = pair[YuvOffsets<Layout_T>::u];
+		const uint8_t v = pair[YuvOffsets<Layout_T>::v];
+
+		rgb.red   = clamp((luma + yuvTables.redV[v]) >> 8);
+		rgb.green = clamp((luma + yuvTables.greenU[u] + yuvTables.greenV[v]) >> 8);
+		rgb.blue  = clamp((luma + yuvTables.blueU[u]) >> 8);
+	}
+
+	///
+	/// Converts consecutive pixels of a packed yuv 4:2:2 row, starting at an even column. Returns
+	/// the number of converted pixels, which is a multiple of the block size of the kernel.
+	///
+	template <PixelLayout Layout_T>
+	unsigned convertYuvBlocks(const uint8_t * data, unsigned count, ColorRgb * destination)
+	{
+#if defined(PIXELCONVERT_NEON)
+		const unsigned blockCount = count / 16;
+		uint8_t * out = reinterpret_cast<uint8_t *>(destination);
+		for (unsigned i = 0; i < blockCount; ++i, data += 32, out += 48)
+		{
+			// deinterleave 8 pixel pairs in even luma, odd luma and the shared chroma
+			const uint8x8x4_t pairs = vld4_u8(data);
+			const uint8x8_t evenLuma = pairs.val[YuvOffsets<Layout_T>::luma];
+			const uint8x8_t oddLuma  = pairs.val[YuvOffsets<Layout_T>::luma + 2];
+			const uint8x8_t u = pairs.val[YuvOffsets<Layout_T>::u];
+			const uint8x8_t v = pairs.val[YuvOffsets<Layout_T>::v];
+
+			const int16x8_t d = vreinterpretq_s16_u16(vsubl_u8(u, vdup_n_u8(128)));
+			const int16x8_t e = vreinterpretq_s16_u16(vsubl_u8(v, vdup_n_u8(128)));
+
+			uint8x8_t red[2], green[2], blue[2];
+			for (unsigned odd = 0; odd < 2; ++odd)
+			{
+				const int16x8_t c = vreinterpretq_s16_u16(vsubl_u8(odd ? oddLuma : evenLuma, vdup_n_u8(16)));
+				const int32x4_t cLow  = vmull_n_s16(vget_low_s16(c),  298);
+				const int32x4_t cHigh = vmull_n_s16(vget_high_s16(c), 298);
+
+				// (x + 128) >> 8 with saturation to [0, 255]
+				red[odd] = vqmovn_u16(vcombine_u16(
+						vqrshrun_n_s32(vmlal_n_s16(cLow,  vget_low_s16(e),  409), 8),
+						vqrshrun_n_s32(vmlal_n_s16(cHigh, vget_high_s16(e), 409), 8)));
+				green[odd] = vqmovn_u16(vcombine_u16(
+						vqrshrun_n_s32(vmlal_n_s16(vmlal_n_s16(cLow,  vget_low_s16(d),  -100), vget_low_s16(e),  -208), 8),
+						vqrshrun_n_s32(vmlal_n_s16(vmlal_n_s16(cHigh, vget_high_s16(d), -100), vget_high_s16(e), -208), 8)));
+				blue[odd] = vqmovn_u16(vcombine_u16(
+						vqrshrun_n_s32(vmlal_n_s16(cLow,  vget_low_s16(d),  516), 8),
+						vqrshrun_n_s32(vmlal_n_s16(cHigh, vget_high_s16(d), 516), 8)));
+			}
+
+			// interleave the even and odd pixels and store as packed rgb
+			const uint8x8x2_t r = vzip_u8(red[0], red[1]);
+			const uint8x8x2_t g = vzip_u8(green[0], green[1]);
+			const uint8x8x2_t b = vzip_u8(blue[0], blue[1]);
+			const uint8x8x3_t first  = {{ r.val[0], g.val[0], b.val[0] }};
+			const uint8x8x3_t second = {{ r.val[1], g.val[1], b.val[1] }};
+			vst3_u8(out,      first);
+			vst3_u8(out + 24, second);
+		}
+		return blockCount * 16;
+#elif defined(PIXELCONVERT_SSE2)
+		const unsigned blockCount = count / 8;
+		const __m128i lowBytes   = _mm_set1_epi16(0x00FF);
+		const __m128i lowWords   = _mm_set1_epi32(0x0000FFFF);
+		const __m128i lumaOffset = _mm_set1_epi16(16);
+		const __m128i chromaOffset = _mm_set1_epi16(128);
+		const __m128i rounding   = _mm_set1_epi32(128);
+		const __m128i one        = _mm_set1_epi16(1);
+		const __m128i zero       = _mm_setzero_si128();
+
+		// coefficient pairs for _mm_madd_epi16
+		const __m128i redCE   = _mm_setr_epi16(298,  409, 298,  409, 298,  409, 298,  409);
+		const __m128i greenCD = _mm_setr_epi16(298, -100, 298, -100, 298, -100, 298, -100);
+		const __m128i greenE1 = _mm_setr_epi16(-208, 128, -208, 128, -208, 128, -208, 128);
+		const __m128i blueCD  = _mm_setr_epi16(298,  516, 298,  516, 298,  516, 298,  516);
+
+		for (unsigned i = 0; i < blockCount; ++i, data += 16, destination += 8)
+		{
+			const __m128i pairs = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+
+			// split the luma of the 8 pixels and the chroma of the 4 pairs in 16-bit lanes
+			const __m128i luma   = (Layout_T == PIXELLAYOUT_UYVY) ? _mm_srli_epi16(pairs, 8) : _mm_and_si128(pairs, lowBytes);
+			const __m128i chroma = (Layout_T == PIXELLAYOUT_UYVY) ? _mm_and_si128(pairs, lowBytes) : _mm_srli_epi16(pairs, 8);
+
+			// duplicate the chroma for both pixels of a pair
+			__m128i u = _mm_and_si128(chroma, lowWords);
+			u = _mm_or_si128(u, _mm_slli_epi32(u, 16));
+			__m128i v = _mm_srli_epi32(chroma, 16);
+			v = _mm_or_si128(v, _mm_slli_epi32(v, 16));
+
+			const __m128i c = _mm_sub_epi16(luma, lumaOffset);
+			const __m128i d = _mm_sub_epi16(u, chromaOffset);
+			const __m128i e = _mm_sub_epi16(v, chromaOffset);
+
+			const __m128i red = _mm_packs_epi32(
+					_mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(c, e), redCE), rounding), 8),
+					_mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(c, e), redCE), rounding), 8));
+			const __m128i green = _mm_packs_epi32(
+					_mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(c, d), greenCD), _mm_madd_epi16(_mm_unpacklo_epi16(e, one), greenE1)), 8),
+					_mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(c, d), greenCD), _mm_madd_epi16(_mm_unpackhi_epi16(e, one), greenE1)), 8));
+			const __m128i blue = _mm_packs_epi32(
+					_mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(c, d), blueCD), rounding), 8),
+					_mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(c, d), blueCD), rounding), 8));
+
+			// saturate to [0, 255] and store as packed rgb
+			uint8_t channels[3][16];
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(channels[0]), _mm_packus_epi16(red,   zero));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(channels[1]), _mm_packus_epi16(green, zero));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(channels[2]), _mm_packus_epi16(blue,  zero));
+			for (unsigned pixel = 0; pixel < 8; ++pixel)
+			{
+				destination[pixel] = ColorRgb{channels[0][pixel], channels[1][pixel], channels[2][pixel]};
+			}
+		}
+		return blockCount * 8;
+#else
+		(void) data;
+		(void) count;
+		(void) destination;
+		return 0;
+#endif
+	}
+
+	///
+	/// Converts a packed yuv 4:2:2 row
+	///
+	template <PixelLayout Layout_T>
+	void convertYuvRow(const uint8_t * row, unsigned column, unsigned step, unsigned count, ColorRgb * destination)
+	{
+		if (step == 1 && count > 0)
+		{
+			// align to the start of a pixel pair for the vectorised kernel
+			if (column & 1)
+			{
+				convertYuvPixel<Layout_T>(row, column, *destination);
+				++column;
+				++destination;
+				--count;
+			}
+
+			const unsigned converted = convertYuvBlocks<Layout_T>(row + column * 2, count, destination);
+			column += converted;
+			destination += converted;
+			count -= converted;
+		}
+
+		// the remaining (or decimated) pixels
+		for (; count > 0; --count, column += step, ++destination)
+		{
+			convertYuvPixel<Layout_T>(row, column, *destination);
+		}
+	}
+}
+
+template <>
+void convertRow<PIXELLAYOUT_YUYV>(const uint8_t * row, unsigned column, unsigned step, unsigned count, ColorRgb * destination)
+{
+	convertYuvRow<PIXELLAYOUT_YUYV>(row, column, step, count, destination);
+}
+
+template <>
+void convertRow<PIXELLAYOUT_UYVY>(const uint8_t * row, unsigned column, unsigned step, unsigned count, ColorRgb * destination)
+{
+	convertYuvRow<PIXELLAYOUT_UYVY>(row, column, step, count, destination);
+}
+
+template <>
+void convertRow<PIXELLAYOUT_RGB32>(const uint8_t * row, unsigned column, unsigned step, unsigned count, ColorRgb * destination)
+{
+	const uint8_t * data = row + column * 4;
+
+#if defined(PIXELCONVERT_NEON)
+	if (step == 1)
+	{
+		// drop the fourth byte of 16 pixels at once
+		const unsigned blockCount = count / 16;
+		uint8_t * out = reinterpret_cast<uint8_t *>(destination);
+		for (unsigned i = 0; i < blockCount; ++i, data += 64, out += 48)
+		{
+			const uint8x16x4_t rgbx = vld4q_u8(data);
+			const uint8x16x3_t rgb = {{ rgbx.val[0], rgbx.val[1], rgbx.val[2] }};
+			vst3q_u8(out, rgb);
+		}
+		destination += blockCount * 16;
+		count -= blockCount * 16;
+	}
+#endif
+
+	for (; count > 0; --count, data += step * 4, ++destination)
+	{
+		destination->red   = data[0];
+		destination->green = data[1];
+		destination->blue  = data[2];
+	}
+}
@@ -210,6 +210,7 @@ int main(int argc, char** argv)
 					grabberConfig.get("redSignalThreshold", 0.0).asDouble(),
 					grabberConfig.get("greenSignalThreshold", 0.0).asDouble(),
 					grabberConfig.get("blueSignalThreshold", 0.0).asDouble(),
+					grabberConfig.get("captureThread", false).asBool(),
 					&hyperion,
 					grabberConfig.get("priority", 800).asInt());
 		v4l2Grabber->set3D(parse3DMode(grabberConfig.get("mode", "2D").asString()));
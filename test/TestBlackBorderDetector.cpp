@@ -4,6 +4,7 @@
 
 // Hyperion includes
 #include <utils/ColorRgb.h>
+#include <utils/ImageView.h>
 
 // Blackborder includes
 #include <blackborder/BlackBorderDetector.h>
@@ -132,6 +133,54 @@ int TC_UNKNOWN_BORDER()
 	return result;
 }
 
+int TC_DARK_PICTURE()
+{
+	int result = 0;
+
+	BlackBorderDetector detector(3);
+
+	{
+		// the top of the picture is dark, except for some pixels next to the probed columns
+		Image<ColorRgb> image = createImage(64, 64, 12, 0);
+		for (unsigned y=12; y<20; ++y)
+		{
+			for (unsigned x=0; x<image.width(); ++x)
+			{
+				image(x,y) = (x % 8 == 3) ? ColorRgb::WHITE : ColorRgb::BLACK;
+			}
+		}
+
+		BlackBorder border = detector.process(image);
+		if (border.unknown != false || border.horizontalSize != 12 || border.verticalSize != 0)
+		{
+			std::cerr << "Failed to detect horizontal border above a dark picture" << std::endl;
+			result = -1;
+		}
+	}
+	return result;
+}
+
+int TC_IMAGE_VIEW()
+{
+	int result = 0;
+
+	BlackBorderDetector detector(3);
+
+	{
+		// a view on the lower right part of a larger image (the rows of the view are padded)
+		Image<ColorRgb> image = createImage(80, 80, 20, 24);
+		const ImageView<ColorRgb> view = ImageView<ColorRgb>(image).subView(16, 10, 64, 64);
+
+		BlackBorder border = detector.process(view);
+		if (border.unknown != false || border.horizontalSize != 10 || border.verticalSize != 8)
+		{
+			std::cerr << "Failed to detect dual border on a view" << std::endl;
+			result = -1;
+		}
+	}
+	return result;
+}
+
 int main()
 {
 	TC_NO_BORDER();
@@ -139,6 +188,8 @@ int main()
 	TC_LEFT_BORDER();
 	TC_DUAL_BORDER();
 	TC_UNKNOWN_BORDER();
+	TC_DARK_PICTURE();
+	TC_IMAGE_VIEW();
 
 	return 0;
 }
@@ -0,0 +1,97 @@
+
+// STL includes
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+// Utils includes
+#include <utils/Image.h>
+#include <utils/ColorRgb.h>
+#include <utils/PixelConvert.h>
+#include <utils/YuvImage.h>
+
+/// The size of the test frame
+const unsigned frameWidth  = 720;
+const unsigned frameHeight = 16;
+
+bool equal(const ColorRgb & lhs, const ColorRgb & rhs)
+{
+	return lhs.red == rhs.red && lhs.green == rhs.green && lhs.blue == rhs.blue;
+}
+
+///
+/// Converts a grid of a random yuv frame with the conversion kernels and compares the result
+/// against the per-pixel conversion of the YuvImage.
+///
+template <PixelLayout Layout_T>
+int compareYuv(const char * name, const std::vector<uint8_t> & frame, unsigned xOffset, unsigned xStep)
+{
+	const unsigned width = (frameWidth - xOffset + xStep - 1) / xStep;
+	const unsigned height = frameHeight / 2;
+
+	Image<ColorRgb> image(width, height);
+	convertFrame<Layout_T>(frame.data(), frameWidth * 2, xOffset, 1, xStep, 2, image);
+
+	const YuvImage reference(frame.data(), frameWidth * 2, Layout_T == PIXELLAYOUT_UYVY, width, height, xOffset, 1, xStep, 2);
+	for (unsigned y = 0; y < height; ++y)
+	{
+		for (unsigned x = 0; x < width; ++x)
+		{
+			const ColorRgb expected = reference(x, y);
+			if (!equal(image(x, y), expected))
+			{
+				std::cerr << name << " offset=" << xOffset << " step=" << xStep << ": pixel (" << x << "," << y << ") is " << image(x, y) << " instead of " << expected << std::endl;
+				return -1;
+			}
+		}
+	}
+	return 0;
+}
+
+int compareRgb32(const std::vector<uint8_t> & frame, unsigned xOffset, unsigned xStep)
+{
+	const unsigned width = (frameWidth - xOffset + xStep - 1) / xStep;
+
+	Image<ColorRgb> image(width, frameHeight);
+	convertFrame<PIXELLAYOUT_RGB32>(frame.data(), frameWidth * 4, xOffset, 0, xStep, 1, image);
+
+	for (unsigned y = 0; y < frameHeight; ++y)
+	{
+		for (unsigned x = 0; x < width; ++x)
+		{
+			const uint8_t * pixel = frame.data() + (y * frameWidth + xOffset + x * xStep) * 4;
+			if (!equal(image(x, y), ColorRgb{pixel[0], pixel[1], pixel[2]}))
+			{
+				std::cerr << "RGB32 offset=" << xOffset << " step=" << xStep << ": pixel (" << x << "," << y << ") differs" << std::endl;
+				return -1;
+			}
+		}
+	}
+	return 0;
+}
+
+int main()
+{
+	std::vector<uint8_t> frame(frameWidth * frameHeight * 4);
+	for (uint8_t & byte : frame)
+	{
+		byte = uint8_t(std::rand());
+	}
+
+	int result = 0;
+	for (unsigned xOffset : {0, 1, 5})
+	{
+		for (unsigned xStep : {1, 2, 3})
+		{
+			result |= compareYuv<PIXELLAYOUT_YUYV>("YUYV", frame, xOffset, xStep);
+			result |= compareYuv<PIXELLAYOUT_UYVY>("UYVY", frame, xOffset, xStep);
+			result |= compareRgb32(frame, xOffset, xStep);
+		}
+	}
+
+	if (result == 0)
+	{
+		std::cout << "Conversion kernels match the reference conversion" << std::endl;
+	}
+	return result;
+}
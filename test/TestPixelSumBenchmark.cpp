@@ -0,0 +1,95 @@
+
+// STL includes
+#include <chrono>
+#include <iostream>
+
+// QT includes
+#include <QImage>
+
+// Utils includes
+#include <utils/Image.h>
+#include <utils/ColorRgb.h>
+#include <utils/ColorRgba.h>
+#include <utils/PixelSum.h>
+
+/// The size to which the test images are scaled before summing
+const unsigned benchmarkWidth  = 1920;
+const unsigned benchmarkHeight = 1080;
+
+/// The number of times each image is summed
+const unsigned iterations = 100;
+
+template <typename Pixel_T, typename Sum_T>
+double benchmark(const Image<Pixel_T> & image, Sum_T sum, ChannelSums & sums)
+{
+	const auto start = std::chrono::high_resolution_clock::now();
+	for (unsigned i = 0; i < iterations; ++i)
+	{
+		sums = {0, 0, 0};
+		for (unsigned y = 0; y < image.height(); ++y)
+		{
+			sum(image.memptr() + y * image.width(), image.width(), sums);
+		}
+	}
+	const auto end = std::chrono::high_resolution_clock::now();
+	return std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+}
+
+template <typename Pixel_T>
+int compare(const char * name, const Image<Pixel_T> & image)
+{
+	ChannelSums scalarSums;
+	ChannelSums kernelSums;
+	const double scalarTime = benchmark(image, sumPixelsScalar<Pixel_T>, scalarSums);
+	const double kernelTime = benchmark(image, [](const Pixel_T * pixels, unsigned count, ChannelSums & sums){ sumPixels(pixels, count, sums); }, kernelSums);
+
+	std::cout << name << ": scalar=" << scalarTime << "ms kernel=" << kernelTime << "ms" << std::endl;
+
+	if (scalarSums.red != kernelSums.red || scalarSums.green != kernelSums.green || scalarSums.blue != kernelSums.blue)
+	{
+		std::cerr << name << ": kernel result differs from scalar result" << std::endl;
+		return -1;
+	}
+	return 0;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		std::cout << "Usage: test_pixelsum_benchmark [image.bmp]..." << std::endl;
+		return -1;
+	}
+
+	int result = 0;
+	for (int i = 1; i < argc; ++i)
+	{
+		QImage source(argv[i]);
+		if (source.isNull())
+		{
+			std::cerr << "Unable to load " << argv[i] << std::endl;
+			result = -1;
+			continue;
+		}
+
+		const QImage scaled = source.scaled(benchmarkWidth, benchmarkHeight).convertToFormat(QImage::Format_RGB32);
+		std::cout << "Image " << argv[i] << " scaled to " << benchmarkWidth << "x" << benchmarkHeight << std::endl;
+
+		Image<ColorRgb> imageRgb(benchmarkWidth, benchmarkHeight);
+		Image<ColorRgba> imageRgba(benchmarkWidth, benchmarkHeight);
+		for (unsigned y = 0; y < benchmarkHeight; ++y)
+		{
+			for (unsigned x = 0; x < benchmarkWidth; ++x)
+			{
+				const QRgb pixel = scaled.pixel(x, y);
+				imageRgb(x, y) = ColorRgb{uint8_t(qRed(pixel)), uint8_t(qGreen(pixel)), uint8_t(qBlue(pixel))};
+				imageRgba(x, y) = ColorRgba{uint8_t(qRed(pixel)), uint8_t(qGreen(pixel)), uint8_t(qBlue(pixel)), 255};
+			}
+		}
+
+		result |= compare("ColorRgb ", imageRgb);
+		result |= compare("ColorRgba", imageRgba);
+	}
+
+	return result;
+}
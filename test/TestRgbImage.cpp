@@ -20,6 +20,57 @@ int main()
 		}
 	}
 
+	std::cout << "Copying image" << std::endl;
+	const Image<ColorRgb> copy(image);
+	if (copy.memptr() != image.constMemptr())
+	{
+		std::cerr << "Copy does not share the pixels" << std::endl;
+		return -1;
+	}
+
+	std::cout << "Reading shared image" << std::endl;
+	const Image<ColorRgb> & constImage = image;
+	if (constImage(63,63).red != ColorRgb::RED.red || image.constMemptr() != copy.memptr())
+	{
+		std::cerr << "Reading a shared image copied the pixels" << std::endl;
+		return -1;
+	}
+
+	std::cout << "Writing shared image" << std::endl;
+	image(0,0) = ColorRgb::GREEN;
+	if (copy(0,0).red != ColorRgb::RED.red || copy.memptr() == image.constMemptr())
+	{
+		std::cerr << "Writing to a shared image changed the copy" << std::endl;
+		return -1;
+	}
+
+	std::cout << "Moving image" << std::endl;
+	Image<ColorRgb> moved(std::move(image));
+	if (image.width() != 0 || moved.width() != 64 || moved(0,0).green != ColorRgb::GREEN.green)
+	{
+		std::cerr << "Move did not take over the pixels" << std::endl;
+		return -1;
+	}
+
+	std::cout << "Copying moved-from image" << std::endl;
+	Image<ColorRgb> empty(image);
+	empty = image;
+	empty.copy(image);
+	if (empty.width() != 0 || empty.height() != 0)
+	{
+		std::cerr << "Copy of a moved-from image is not empty" << std::endl;
+		return -1;
+	}
+
+	std::cout << "Reusing moved-from image" << std::endl;
+	image.resize(8, 8);
+	image(7,7) = ColorRgb::BLUE;
+	if (image(7,7).blue != ColorRgb::BLUE.blue)
+	{
+		std::cerr << "Moved-from image can not be reused" << std::endl;
+		return -1;
+	}
+
 	std::cout << "Finished (destruction will be performed)" << std::endl;
 
 	return 0;